@@ -0,0 +1,92 @@
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Stamp the NVM image CRC into the '.version' section of the linked ELF file.
+
+    image_crc_stamp.py image_nvm_nocrc.elf image_nvm.elf
+
+The CRC-32 (zlib) is calculated over the address range checked by the firmware
+at startup (image_check.h): APARAM up to the OTA staging area, bytes not
+covered by the ELF file count as erased (0xFF). The device data (APARAM
+secret[] and public[]) is skipped. The version page lies outside of this
+range, so stamping does not change the CRC.
+
+Called by imagebuild.mk, runs with Python 2.7 and 3.
+"""
+
+import struct
+import sys
+import zlib
+
+IMAGE_START = 0x00010400        # OTA_IMAGE_START
+IMAGE_END = 0x0001D180          # OTA_STAGE_BASE
+DEVICE_START = 0x00010600       # IMAGE_DEVICE_START, device data is not covered
+DEVICE_END = 0x00010800         # IMAGE_DEVICE_END
+VERSION_SECTION = b".version"
+VERSION_CRC_OFFSET = 8          # offsetof(Version_t, crc)
+
+
+def fail(message):
+    sys.stderr.write("image_crc_stamp: %s\n" % message)
+    sys.exit(1)
+
+
+def image_crc(elf):
+    phoff, = struct.unpack_from("<I", elf, 0x1C)
+    phentsize, phnum = struct.unpack_from("<HH", elf, 0x2A)
+    image = bytearray(b"\xff" * (IMAGE_END - IMAGE_START))
+    for i in range(phnum):
+        p_type, p_offset, _, p_paddr, p_filesz = struct.unpack_from("<5I", elf, phoff + i * phentsize)
+        if p_type != 1 or p_filesz == 0:
+            continue
+        start = max(p_paddr, IMAGE_START)
+        end = min(p_paddr + p_filesz, IMAGE_END)
+        if start < end:
+            src = p_offset + start - p_paddr
+            image[start - IMAGE_START:end - IMAGE_START] = elf[src:src + end - start]
+    crc = zlib.crc32(bytes(image[:DEVICE_START - IMAGE_START]))
+    crc = zlib.crc32(bytes(image[DEVICE_END - IMAGE_START:]), crc)
+    return crc & 0xFFFFFFFF
+
+
+def version_offset(elf):
+    """File offset of the '.version' section."""
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+    strtab_offset, = struct.unpack_from("<I", elf, shoff + shstrndx * shentsize + 0x10)
+    for i in range(shnum):
+        sh_name, _, _, _, sh_offset, sh_size = struct.unpack_from("<6I", elf, shoff + i * shentsize)
+        name_start = strtab_offset + sh_name
+        name = bytes(elf[name_start:elf.index(b"\0", name_start)])
+        if name == VERSION_SECTION:
+            if sh_size < VERSION_CRC_OFFSET + 4:
+                fail("section %s too small" % VERSION_SECTION.decode())
+            return sh_offset
+    fail("no section %s" % VERSION_SECTION.decode())
+
+
+def main():
+    if len(sys.argv) != 3:
+        fail("usage: image_crc_stamp.py <input.elf> <output.elf>")
+
+    with open(sys.argv[1], "rb") as f:
+        elf = bytearray(f.read())
+    if elf[:4] != bytearray(b"\x7fELF") or elf[4] != 1 or elf[5] != 1:
+        fail("%s is not a 32 bit little endian ELF file" % sys.argv[1])
+
+    crc = image_crc(elf)
+    struct.pack_into("<I", elf, version_offset(elf) + VERSION_CRC_OFFSET, crc)
+    with open(sys.argv[2], "wb") as f:
+        f.write(elf)
+    print("image CRC 0x%08x" % crc)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Decode the binary UART log (smack_sl/inc/log.h) with the format strings of the ELF file.
+
+    log_decode.py smack_sl.elf --port /dev/ttyUSB0
+    log_decode.py smack_sl.elf --input capture.bin
+
+The firmware sends a header word (id, argument count, sync byte 0xA5) and the
+raw 32 bit arguments of every message. The id is the offset of the format
+string in the section .log_fmt, which is read from the ELF file of the same
+build. Bytes which do not start a valid header are skipped, so the decoder
+resynchronizes after a loss. Reading from a port needs pyserial.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION = ".log_fmt"
+LOG_SYNC = 0xA5
+LOG_ID_DROPPED = 0xFFFF
+
+SPEC_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z)?([diuxXoc%s])")
+
+
+def read_section(path, name):
+    """Return the contents of section name of an ELF32 little endian file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit("%s: not an ELF32 little endian file" % path)
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def header(index):
+        return struct.unpack_from("<IIIIIIIIII", elf, shoff + index * shentsize)
+
+    strtab = header(shstrndx)
+    for index in range(shnum):
+        sh = header(index)
+        start = strtab[4] + sh[0]
+        if elf[start:elf.index(b"\0", start)].decode() == name:
+            return elf[sh[4]:sh[4] + sh[5]]
+    sys.exit("%s: no section %s, built without UART_LOG?" % (path, name))
+
+
+def load_formats(path):
+    """Return {id: (format, argument count)} of all strings in the section."""
+    data = read_section(path, SECTION)
+    formats = {}
+    offset = 0
+    while offset < len(data):
+        end = data.index(b"\0", offset)
+        fmt = data[offset:end].decode("ascii", "replace")
+        count = sum(1 for m in SPEC_RE.finditer(fmt) if m.group(2) != "%")
+        formats[offset] = (fmt, count)
+        # strings are placed with the alignment of their type, skip the padding
+        offset = end + 1
+        while offset < len(data) and data[offset:offset + 1] == b"\0":
+            offset += 1
+    formats[LOG_ID_DROPPED] = ("*** %u messages dropped ***", 1)
+    return formats
+
+
+def render(fmt, args):
+    """printf the arguments, 32 bit like the target."""
+    values = iter(args)
+
+    def convert(m):
+        flags, conv = m.groups()
+        if conv == "%":
+            return "%"
+        value = next(values)
+        if conv in "di" and value & 0x80000000:
+            value -= 1 << 32
+        elif conv == "c":
+            value = value & 0xFF
+        elif conv == "s":
+            flags, conv = "#", "x"
+        return ("%" + flags + conv) % value
+
+    return SPEC_RE.sub(convert, fmt)
+
+
+class Decoder(object):
+    def __init__(self, formats):
+        self.formats = formats
+        self.buffer = bytearray()
+        self.skipped = 0
+
+    def feed(self, data):
+        """Append received bytes, return the decoded messages."""
+        self.buffer += data
+        messages = []
+        while len(self.buffer) >= 4:
+            header, = struct.unpack_from("<I", self.buffer, 0)
+            ident, count = header & 0xFFFF, (header >> 16) & 0xFF
+            entry = self.formats.get(ident)
+            if (header >> 24) != LOG_SYNC or entry is None or entry[1] != count:
+                del self.buffer[0]
+                self.skipped += 1
+                continue
+            size = 4 * (count + 1)
+            if len(self.buffer) < size:
+                break
+            if self.skipped:
+                messages.append("*** %d bytes skipped ***" % self.skipped)
+                self.skipped = 0
+            args = struct.unpack_from("<%dI" % count, self.buffer, 4)
+            messages.append(render(entry[0], args))
+            del self.buffer[:size]
+        return messages
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the running firmware")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port to read from")
+    source.add_argument("--input", help="file with captured UART data")
+    parser.add_argument("--baud", type=int, default=115200, help="baudrate (default: 115200, LOG_BAUDRATE)")
+    args = parser.parse_args()
+
+    decoder = Decoder(load_formats(args.elf))
+
+    if args.input:
+        with open(args.input, "rb") as f:
+            for message in decoder.feed(f.read()):
+                print(message)
+        return 0
+
+    import serial
+    port = serial.Serial(args.port, args.baud, timeout=0.1)
+    try:
+        while True:
+            for message in decoder.feed(port.read(256)):
+                print(message)
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Flash only the NVM pages which differ from a reference image.
+
+    nvm_delta_flash.py diff smack_sl/build/image/image_nvm.hex reference.hex -o delta/
+    JLink.exe -CommanderScript delta/flash_nvm_delta.jlink
+    nvm_delta_flash.py record smack_sl/build/image/image_nvm.hex reference.hex
+
+"diff" compares a built image (.hex or .elf) against the reference image
+recorded for the boards on the line. It writes the changed pages into
+delta.hex and creates a J-Link Commander script which programs just this file.
+J-Link erases and programs only the pages contained in the file, so a release
+that touches APARAM and a few code pages takes a few page cycles instead of
+the whole image. Without a reference, all pages of the image are written.
+
+"record" stores an image as the new reference. Use it once the line has been
+switched to the new image, all boards flashed from then on must start from it.
+"""
+
+import argparse
+import os
+import sys
+
+import nvm_image as nvm
+
+JLINK_SCRIPT = """device NAC1080
+si SWD
+speed 4000
+r
+h
+{load}
+r
+exit
+"""
+
+
+def delta_pages(image, reference):
+    """Pages of image which differ from reference (erased pages count as 0xFF)."""
+    result = {}
+    for address, content in image.items():
+        if address < nvm.APARAM_BASE or address == nvm.PERSIST_PAGE or nvm.is_device_page(address):
+            continue
+        if reference is None or nvm.page(reference, address) != content:
+            result[address] = content
+    return result
+
+
+def ranges(addresses):
+    """Merge page addresses into (start, end) ranges of consecutive pages."""
+    result = []
+    for address in sorted(addresses):
+        if result and result[-1][1] == address:
+            result[-1][1] = address + nvm.PAGE_SIZE
+        else:
+            result.append([address, address + nvm.PAGE_SIZE])
+    return result
+
+
+def cmd_diff(args):
+    image = nvm.pages(nvm.load_image(args.image))
+    reference = None
+    if os.path.exists(args.reference):
+        reference = nvm.pages(nvm.load_image(args.reference))
+    else:
+        print("warning: no reference %s, writing the complete image" % args.reference, file=sys.stderr)
+
+    delta = delta_pages(image, reference)
+    for start, end in ranges(delta):
+        print("0x%05x-0x%05x  %3d page(s)" % (start, end - 1, (end - start) // nvm.PAGE_SIZE))
+    print("%d of %d pages changed" % (len(delta), len(image)))
+
+    os.makedirs(args.output, exist_ok=True)
+    hex_path = os.path.join(args.output, "delta.hex")
+    script_path = os.path.join(args.output, "flash_nvm_delta.jlink")
+    nvm.save_hex(delta, hex_path)
+    with open(script_path, "w") as f:
+        # nothing to program: the script still resets the device, so the station flow is unchanged
+        load = "loadfile %s" % os.path.abspath(hex_path) if delta else ""
+        f.write(JLINK_SCRIPT.format(load=load))
+
+
+def cmd_record(args):
+    nvm.save_hex(nvm.pages(nvm.load_image(args.image)), args.reference)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command")
+    sub.required = True
+
+    diff = sub.add_parser("diff", help="create delta.hex and the J-Link script")
+    diff.add_argument("image", help="built image (.hex or .elf)")
+    diff.add_argument("reference", help="reference image currently on the boards")
+    diff.add_argument("-o", "--output", default=".", help="output directory")
+    diff.set_defaults(func=cmd_diff)
+
+    record = sub.add_parser("record", help="store an image as reference")
+    record.add_argument("image", help="image now used on the line (.hex or .elf)")
+    record.add_argument("reference", help="reference file to write")
+    record.set_defaults(func=cmd_record)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
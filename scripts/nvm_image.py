@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""NVM image helpers shared by the host tools.
+
+Loads Intel HEX or ELF files as produced by imagebuild.mk (image_nvm.hex,
+image_nvm.elf) and splits them into NVM pages. Bytes not present in the file
+read as 0xFF, which is the content of an erased NVM.
+"""
+
+import struct
+import zlib
+
+PAGE_SIZE = 128
+ERASED = 0xFF
+
+DPARAM_BASE = 0x00010000
+APARAM_BASE = 0x00010400
+NVM_BASE = 0x00010800
+NVM_END = 0x0001F000            # end of the last NVM page
+PERSIST_PAGE = 0x0001EF00       # application data, never part of an image (nvm_persist.h)
+OTA_STAGE_BASE = 0x0001D180     # staging area for updates (ota.h)
+OTA_VERSION_PAGE = 0x0001EF80
+DEVICE_START = 0x00010600       # APARAM secret[] and public[], written per device (provision.h)
+DEVICE_END = 0x00010800
+
+
+class HexError(Exception):
+    pass
+
+
+def load_hex(path):
+    """Return a dict address -> byte with the content of an Intel HEX file."""
+    data = {}
+    base = 0
+    with open(path, "r") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.strip()
+            if not line:
+                continue
+            if not line.startswith(":"):
+                raise HexError("%s:%d: not a record" % (path, lineno))
+            raw = bytes.fromhex(line[1:])
+            if len(raw) < 5 or len(raw) != raw[0] + 5:
+                raise HexError("%s:%d: bad length" % (path, lineno))
+            if sum(raw) & 0xFF:
+                raise HexError("%s:%d: bad checksum" % (path, lineno))
+            count, addr, rtype, payload = raw[0], (raw[1] << 8) | raw[2], raw[3], raw[4:-1]
+            if rtype == 0x00:
+                for i, b in enumerate(payload):
+                    data[base + addr + i] = b
+            elif rtype == 0x01:
+                break
+            elif rtype == 0x02:
+                base = int.from_bytes(payload, "big") << 4
+            elif rtype == 0x04:
+                base = int.from_bytes(payload, "big") << 16
+            elif rtype in (0x03, 0x05):
+                pass    # start address records
+            else:
+                raise HexError("%s:%d: unknown record type %d" % (path, lineno, rtype))
+    return data
+
+
+def load_elf(path):
+    """Return a dict address -> byte with the loadable segments of an ELF file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise HexError("%s: not a 32 bit little endian ELF file" % path)
+    phoff, = struct.unpack_from("<I", elf, 0x1C)
+    phentsize, phnum = struct.unpack_from("<HH", elf, 0x2A)
+    data = {}
+    for i in range(phnum):
+        p_type, p_offset, _, p_paddr, p_filesz = struct.unpack_from("<5I", elf, phoff + i * phentsize)
+        if p_type != 1 or p_filesz == 0:     # PT_LOAD with content only, NOLOAD sections have none
+            continue
+        for j, b in enumerate(elf[p_offset:p_offset + p_filesz]):
+            data[p_paddr + j] = b
+    return data
+
+
+def load_image(path):
+    """Load an image from .elf or .hex, depending on the file extension."""
+    return load_elf(path) if path.lower().endswith(".elf") else load_hex(path)
+
+
+def save_hex(image_pages, path):
+    """Write pages as Intel HEX file."""
+    def record(rtype, address, payload):
+        raw = bytes([len(payload), (address >> 8) & 0xFF, address & 0xFF, rtype]) + payload
+        return ":%s%02X\n" % (raw.hex().upper(), (-sum(raw)) & 0xFF)
+
+    upper = None
+    with open(path, "w") as f:
+        for address in sorted(image_pages):
+            content = image_pages[address]
+            for i in range(0, len(content), 16):
+                a = address + i
+                if (a >> 16) != upper:
+                    upper = a >> 16
+                    f.write(record(0x04, 0, upper.to_bytes(2, "big")))
+                f.write(record(0x00, a & 0xFFFF, content[i:i + 16]))
+        f.write(record(0x01, 0, b""))
+
+
+def pages(data):
+    """Return a dict page address -> bytes(PAGE_SIZE) for every page touched by data."""
+    result = {}
+    for page in sorted({a & ~(PAGE_SIZE - 1) for a in data}):
+        result[page] = bytes(data.get(page + i, ERASED) for i in range(PAGE_SIZE))
+    return result
+
+
+def is_device_page(address):
+    """True for pages holding device data, which images and updates leave untouched."""
+    return DEVICE_START <= address < DEVICE_END
+
+
+def page(image_pages, address):
+    """Page content at address, erased if the image does not cover it."""
+    return image_pages.get(address, bytes([ERASED]) * PAGE_SIZE)
+
+
+def crc32(data, crc=0):
+    """CRC-32 as calculated by crc32.c on the device."""
+    return zlib.crc32(data, crc) & 0xFFFFFFFF
+
+
+def words(data):
+    """Split bytes into little endian 32 bit words."""
+    return [int.from_bytes(data[i:i + 4], "little") for i in range(0, len(data), 4)]
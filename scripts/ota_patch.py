@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Create a delta patch for the NFC firmware update (smack_sl/inc/ota.h).
+
+    ota_patch.py old/image_nvm.hex new/image_nvm.hex -o update.otap
+
+Only NVM pages which differ between the images are part of the patch, and of
+those only the changed words are sent (runs of copied words, or a single word
+for runs of a repeated value).
+
+The patch file is a list of mailbox requests for the reader app:
+
+    header  "OTAP", u16 version, u16 frame count, u32 image CRC, u32 page count
+    frame   u16 slot (0xFFFF: not page related), u16 word count, u32 words[]
+
+All values are little endian. For each frame, the reader writes the words to
+the mailbox starting at word 32 (OTA_MBX_OFFSET) and calls app function 2
+(OTA_APP_FUNCTION). The function returns an ota_status_t:
+
+    0 ok, 1 staged: the page is already in its slot, skip the following
+    frames of the same slot, anything else: abort.
+
+After a field loss, the reader starts again with the first frame. Pages which
+made it into their slot are answered with "staged" and not sent again. The
+last frame (OTA_CMD_ACTIVATE) resets the device, so its reply is lost.
+"""
+
+import argparse
+import struct
+import sys
+
+import nvm_image as nvm
+
+OTA_MBX_OFFSET = 32
+MAILBOX_SIZE = 64
+OTA_MAX_PAYLOAD = MAILBOX_SIZE - OTA_MBX_OFFSET - 4
+OTA_STAGE_SLOTS = 58
+OTA_PAGE_WORDS = nvm.PAGE_SIZE // 4
+
+OTA_CMD_BEGIN = 0x4F540001
+OTA_CMD_PAGE = 0x4F540002
+OTA_CMD_DATA = 0x4F540003
+OTA_CMD_COMMIT = 0x4F540004
+OTA_CMD_ACTIVATE = 0x4F540005
+
+OTA_RUN_FILL = 0x80000000
+MIN_FILL = 3                    # shorter repeats are cheaper as copy
+NO_SLOT = 0xFFFF
+
+
+def changed_pages(old, new):
+    """Page addresses the update has to write."""
+    candidates = set(old) | set(new)
+    result = []
+    for address in sorted(candidates):
+        in_image = nvm.APARAM_BASE <= address < nvm.OTA_STAGE_BASE and not nvm.is_device_page(address)
+        if not (in_image or address == nvm.OTA_VERSION_PAGE):
+            continue
+        if nvm.page(old, address) != nvm.page(new, address):
+            result.append(address)
+    return result
+
+
+def image_crc(new):
+    crc = 0
+    for address in range(nvm.APARAM_BASE, nvm.OTA_STAGE_BASE, nvm.PAGE_SIZE):
+        if not nvm.is_device_page(address):
+            crc = nvm.crc32(nvm.page(new, address), crc)
+    return crc
+
+
+def runs(old_words, new_words):
+    """Split the changed words of a page into (fill, offset, words) runs."""
+    diff = [i for i in range(OTA_PAGE_WORDS) if old_words[i] != new_words[i]]
+    # merge changes separated by a single unchanged word: same cost, one header less
+    spans = []
+    for i in diff:
+        if spans and i - spans[-1][1] <= 2:
+            spans[-1][1] = i + 1
+        else:
+            spans.append([i, i + 1])
+
+    result = []
+    for start, end in spans:
+        copy_start = start
+        i = start
+        while i < end:
+            repeat = 1
+            while i + repeat < end and new_words[i + repeat] == new_words[i]:
+                repeat += 1
+            if repeat >= MIN_FILL:
+                if copy_start < i:
+                    result.append((False, copy_start, new_words[copy_start:i]))
+                result.append((True, i, [new_words[i]] * repeat))
+                i += repeat
+                copy_start = i
+            else:
+                i += repeat
+        if copy_start < end:
+            result.append((False, copy_start, new_words[copy_start:end]))
+    return result
+
+
+def data_frames(slot, page_runs):
+    """Pack runs into OTA_CMD_DATA requests."""
+    payloads = [[]]
+    for fill, offset, values in page_runs:
+        if fill:
+            if len(payloads[-1]) + 2 > OTA_MAX_PAYLOAD:
+                payloads.append([])
+            payloads[-1] += [OTA_RUN_FILL | (offset << 8) | len(values), values[0]]
+            continue
+        while values:
+            room = OTA_MAX_PAYLOAD - len(payloads[-1]) - 1
+            if room < 1:
+                payloads.append([])
+                continue
+            part, values = values[:room], values[room:]
+            payloads[-1] += [(offset << 8) | len(part)] + part
+            offset += len(part)
+
+    frames = []
+    for n, payload in enumerate(payloads):
+        last = 1 if n == len(payloads) - 1 else 0
+        raw = struct.pack("<%dI" % len(payload), *payload)
+        frames.append((slot, [OTA_CMD_DATA, slot, (last << 16) | len(payload), nvm.crc32(raw)] + payload))
+    return frames
+
+
+def build(old, new):
+    pages = changed_pages(old, new)
+    if len(pages) > OTA_STAGE_SLOTS:
+        raise ValueError("%d pages changed, the staging area holds %d" % (len(pages), OTA_STAGE_SLOTS))
+
+    crc = image_crc(new)
+    frames = [(NO_SLOT, [OTA_CMD_BEGIN, crc, len(pages)])]
+    for slot, address in enumerate(pages):
+        new_page = nvm.page(new, address)
+        frames.append((slot, [OTA_CMD_PAGE, slot, address, nvm.crc32(new_page)]))
+        page_runs = runs(nvm.words(nvm.page(old, address)), nvm.words(new_page))
+        frames += data_frames(slot, page_runs)
+    frames.append((NO_SLOT, [OTA_CMD_COMMIT]))
+    frames.append((NO_SLOT, [OTA_CMD_ACTIVATE]))
+    return crc, pages, frames
+
+
+def write_patch(path, crc, pages, frames):
+    with open(path, "wb") as f:
+        f.write(b"OTAP" + struct.pack("<HHII", 1, len(frames), crc, len(pages)))
+        for slot, frame_words in frames:
+            f.write(struct.pack("<HH%dI" % len(frame_words), slot, len(frame_words), *frame_words))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("old", help="image_nvm.hex currently on the device")
+    parser.add_argument("new", help="image_nvm.hex to install")
+    parser.add_argument("-o", "--output", help="patch file to write")
+    parser.add_argument("-v", "--verbose", action="store_true", help="list the changed pages")
+    args = parser.parse_args()
+
+    old = nvm.pages(nvm.load_hex(args.old))
+    new = nvm.pages(nvm.load_hex(args.new))
+    try:
+        crc, pages, frames = build(old, new)
+    except ValueError as e:
+        sys.exit("error: %s" % e)
+
+    if args.verbose:
+        for slot, address in enumerate(pages):
+            print("slot %2d: page 0x%05x" % (slot, address))
+
+    sent = sum(len(w) for _, w in frames) * 4
+    full = nvm.OTA_STAGE_BASE - nvm.APARAM_BASE
+    print("%d pages changed, %d frames, %d bytes to send (full image %d bytes), image CRC 0x%08x"
+          % (len(pages), len(frames), sent, full, crc))
+
+    if args.output:
+        write_patch(args.output, crc, pages, frames)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Map a PC sampling profile (smack_sl/inc/profiler.h) to functions.
+
+    profiler_symbolize.py smack_sl/build/image/image_nvm.map profile.bin
+
+The profile file is what the reader app downloads from a build with PROFILER
+defined: the 24 byte profiler_info_t of data point 0x0097, followed by the
+histogram read with burst reads from profiler_info_t.histogram (buckets + 3
+little endian uint16 counters).
+
+The map file is the one the linker writes next to the ELF. Each bucket covers
+2^shift bytes of NVM code. Its samples are split between the functions which
+overlap the bucket, weighted by the overlap, so small functions sharing a
+bucket with a hot one get an estimate only. Build with a smaller
+PROFILER_BUCKET_SHIFT for a finer resolution.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+INFO_FORMAT = "<IIIIHBB"
+INFO_SIZE = struct.calcsize(INFO_FORMAT)
+BINS = ("<ROM>", "<RAM code>", "<rejected>")
+CORE_CLOCK = 28000000
+
+# " .text.name  0x00010a3c  0x5c  obj" or the same with the values on the next line
+SECTION_RE = re.compile(r"^ (\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.*))?$")
+VALUES_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.*)$")
+SYMBOL_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$")
+
+
+def load_map(path):
+    """Return a sorted list of (start, end, name) of the code in the map file."""
+    functions = []
+    section = None
+    pending = None
+
+    with open(path) as f:
+        lines = iter(f.read().splitlines())
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            break
+    for line in lines:
+        m = SECTION_RE.match(line)
+        if m:
+            pending = m.group(1)
+            if m.group(2) is None:
+                continue
+            values = m.group(2, 3, 4)
+        elif pending is not None and VALUES_RE.match(line):
+            values = VALUES_RE.match(line).group(1, 2, 3)
+        else:
+            m = SYMBOL_RE.match(line)
+            if m and section is not None:
+                address = int(m.group(1), 16)
+                if section[0] <= address < section[1]:
+                    section[2].append((address, m.group(2)))
+            pending = None
+            continue
+
+        name = pending
+        pending = None
+        start, size = int(values[0], 16), int(values[1], 16)
+        if section is not None:
+            functions.extend(split_section(section))
+            section = None
+        if size and (name.startswith(".text") or name.startswith(".ramfunc")):
+            section = (start, start + size, [], "%s(%s)" % (values[2].split("/")[-1], name))
+    if section is not None:
+        functions.extend(split_section(section))
+    return sorted(functions)
+
+
+def split_section(section):
+    """Split an input section at the symbols defined in it."""
+    start, end, symbols, fallback = section
+    symbols = sorted(set(symbols))
+    if not symbols or symbols[0][0] != start:
+        symbols.insert(0, (start, fallback))
+    result = []
+    for i, (address, name) in enumerate(symbols):
+        stop = symbols[i + 1][0] if i + 1 < len(symbols) else end
+        if stop > address:
+            result.append((address, stop, name))
+    return result
+
+
+def load_profile(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < INFO_SIZE:
+        sys.exit("%s: too short for profiler_info_t" % path)
+    _, start, samples, period, buckets, shift, _ = struct.unpack_from(INFO_FORMAT, data)
+    count = buckets + len(BINS)
+    if len(data) < INFO_SIZE + 2 * count:
+        sys.exit("%s: histogram incomplete, %d counters expected" % (path, count))
+    counters = struct.unpack_from("<%dH" % count, data, INFO_SIZE)
+    return start, shift, samples, period, counters[:buckets], counters[buckets:]
+
+
+def attribute(functions, start, shift, histogram):
+    """Distribute the bucket counts to the functions, returns {name: samples}."""
+    size = 1 << shift
+    result = {}
+    unknown = 0.0
+    for index, count in enumerate(histogram):
+        if count == 0:
+            continue
+        low = start + index * size
+        high = low + size
+        covered = 0
+        for f_start, f_end, name in functions:
+            overlap = min(high, f_end) - max(low, f_start)
+            if overlap > 0:
+                result[name] = result.get(name, 0.0) + count * overlap / size
+                covered += overlap
+        unknown += count * (size - covered) / size
+    if unknown >= 0.5:
+        result["<no symbol>"] = unknown
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="linker map file of the profiled build")
+    parser.add_argument("profile", help="profiler_info_t followed by the histogram")
+    parser.add_argument("-n", "--top", type=int, default=30, help="number of functions listed (0: all)")
+    parser.add_argument("--buckets", action="store_true", help="list the non-empty buckets as well")
+    args = parser.parse_args()
+
+    start, shift, samples, period, histogram, bins = load_profile(args.profile)
+    functions = load_map(args.map)
+    if not functions:
+        sys.exit("%s: no code sections found" % args.map)
+
+    result = attribute(functions, start, shift, histogram)
+    for name, count in zip(BINS, bins):
+        if count:
+            result[name] = float(count)
+    total = sum(histogram) + sum(bins)
+    if total == 0:
+        sys.exit("no samples")
+
+    print("%d samples, period %d ticks (%.1f us), %d byte buckets" %
+          (samples, period, period * 1e6 / CORE_CLOCK, 1 << shift))
+    if samples != total:
+        print("note: %d samples lost in saturated counters" % (samples - total))
+    print("")
+    print("%10s %7s  %s" % ("samples", "%", "function"))
+    ranked = sorted(result.items(), key=lambda item: -item[1])
+    if args.top:
+        ranked = ranked[:args.top]
+    for name, count in ranked:
+        print("%10.1f %6.2f%%  %s" % (count, 100.0 * count / total, name))
+
+    if args.buckets:
+        print("")
+        print("%10s %10s  %s" % ("address", "samples", "functions"))
+        size = 1 << shift
+        for index, count in enumerate(histogram):
+            if count:
+                low = start + index * size
+                names = [n for s, e, n in functions if s < low + size and e > low]
+                print("0x%08x %10d  %s" % (low, count, ", ".join(names)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
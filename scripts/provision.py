@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Provision device data over the UART on several stations in parallel (smack_sl/inc/provision.h).
+
+    provision.py bundles.csv --port /dev/ttyUSB0 --port /dev/ttyUSB1 --results results.csv
+
+bundles.csv has a header line and the columns serial, passcode, key (32 hex
+digits) and optionally secret_app and public_app (hex, up to 236 and 252
+bytes). Numbers may be decimal or 0x prefixed hex.
+
+Each port is a station with one device. A station waits until a device
+answers, takes the next bundle, sends it, and checks the serial number after
+the device reset. Then it waits until the device is removed. Devices which are
+already provisioned are skipped, bundles which failed are handed to the next
+device. Every attempt is appended to the results file. Needs pyserial.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import threading
+import time
+import zlib
+
+SOF = 0xA7
+CMD_INFO = 0x01
+CMD_PAGE = 0x02
+CMD_COMMIT = 0x03
+
+PAGE_SIZE = 128
+PAGES = 4
+SECRET_APP = 236
+PUBLIC_APP = 252
+UNPROVISIONED = 0xFFFFFFFF
+
+STATUS = ("ok", "length", "crc", "cmd", "order", "locked", "bundle", "stage")
+RETRIES = 3
+
+
+class ProvisionError(Exception):
+    pass
+
+
+def number(text):
+    return int(text, 0)
+
+
+def load_bundles(path):
+    """Return a list of (serial, bundle bytes) from the CSV file."""
+    bundles = []
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            key = bytes.fromhex(row["key"])
+            secret_app = bytes.fromhex(row.get("secret_app") or "")
+            public_app = bytes.fromhex(row.get("public_app") or "")
+            if len(key) != 16 or len(secret_app) > SECRET_APP or len(public_app) > PUBLIC_APP:
+                sys.exit("%s: bad field length for serial %s" % (path, row["serial"]))
+            serial = number(row["serial"])
+            secret = struct.pack("<I", number(row["passcode"])) + key + secret_app.ljust(SECRET_APP, b"\xff")
+            public = struct.pack("<I", serial) + public_app.ljust(PUBLIC_APP, b"\xff")
+            bundles.append((serial, secret + public))
+    return bundles
+
+
+class Station(object):
+    def __init__(self, port, baud, timeout):
+        import serial
+        self.name = port
+        self.port = serial.Serial(port, baud, timeout=timeout)
+
+    def request(self, cmd, payload=b""):
+        """Send a frame and return (status, reply payload)."""
+        body = bytes([cmd, len(payload)]) + payload
+        self.port.reset_input_buffer()
+        self.port.write(bytes([SOF]) + body + struct.pack("<I", zlib.crc32(body) & 0xFFFFFFFF))
+
+        while True:
+            first = self.port.read(1)
+            if not first:
+                raise ProvisionError("no reply")
+            if first[0] == SOF:
+                break
+        header = self.port.read(2)
+        if len(header) != 2:
+            raise ProvisionError("reply truncated")
+        rest = self.port.read(header[1] + 4)
+        if len(rest) != header[1] + 4:
+            raise ProvisionError("reply truncated")
+        body, crc = header + rest[:-4], struct.unpack("<I", rest[-4:])[0]
+        if zlib.crc32(body) & 0xFFFFFFFF != crc or body[0] != cmd or body[1] < 2:
+            raise ProvisionError("corrupted reply")
+        return body[2], body[3:]
+
+    def check(self, cmd, payload=b""):
+        status, reply = self.request(cmd, payload)
+        if status != 0:
+            name = STATUS[status] if status < len(STATUS) else str(status)
+            raise ProvisionError("%s (ota status %d)" % (name, reply[0]))
+        return reply
+
+    def info(self):
+        """Return (image CRC, serial, baudrate) or None if no device answers."""
+        try:
+            reply = self.check(CMD_INFO)
+        except ProvisionError:
+            return None
+        return struct.unpack_from("<III", reply, 3)
+
+    def provision(self, bundle):
+        for index in range(PAGES):
+            page = bundle[index * PAGE_SIZE:(index + 1) * PAGE_SIZE]
+            for attempt in range(RETRIES):
+                try:
+                    self.check(CMD_PAGE, bytes([index, 0, 0, 0]) + page)
+                    break
+                except ProvisionError:
+                    if attempt == RETRIES - 1:
+                        raise
+        self.check(CMD_COMMIT, struct.pack("<I", zlib.crc32(bundle) & 0xFFFFFFFF))
+
+
+class Line(object):
+    """Bundles and results shared by the stations."""
+
+    def __init__(self, bundles, results):
+        self.bundles = list(bundles)
+        self.results = results
+        self.lock = threading.Lock()
+
+    def take(self):
+        with self.lock:
+            return self.bundles.pop(0) if self.bundles else None
+
+    def give_back(self, item):
+        with self.lock:
+            self.bundles.insert(0, item)
+
+    def record(self, station, serial, result):
+        with self.lock:
+            line = "%s,%s,0x%08X,%s" % (time.strftime("%Y-%m-%d %H:%M:%S"), station, serial, result)
+            print(line)
+            sys.stdout.flush()
+            if self.results:
+                with open(self.results, "a") as f:
+                    f.write(line + "\n")
+
+
+def run_station(station, line, poll, once):
+    while True:
+        info = station.info()
+        if info is None:
+            time.sleep(poll)
+            continue
+
+        if info[1] != UNPROVISIONED:
+            line.record(station.name, info[1], "already provisioned")
+        else:
+            item = line.take()
+            if item is None:
+                return
+            serial, bundle = item
+            try:
+                station.provision(bundle)
+                # the device resets after the commit
+                deadline = time.time() + 3.0
+                info = None
+                while info is None and time.time() < deadline:
+                    time.sleep(poll)
+                    info = station.info()
+                if info is None or info[1] != serial:
+                    raise ProvisionError("serial not read back")
+                line.record(station.name, serial, "ok")
+            except ProvisionError as e:
+                line.give_back(item)
+                line.record(station.name, serial, "failed: %s" % e)
+        if once:
+            return
+
+        # wait until the device is removed
+        while station.info() is not None:
+            time.sleep(poll)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("bundles", help="CSV file with the device data")
+    parser.add_argument("--port", action="append", required=True, help="serial port of a station, repeat per station")
+    parser.add_argument("--baud", type=int, default=1000000, help="baudrate (default: 1000000, PROVISION_BAUDRATE)")
+    parser.add_argument("--results", help="CSV file the results are appended to")
+    parser.add_argument("--poll", type=float, default=0.2, help="seconds between polls for a device (default: 0.2)")
+    parser.add_argument("--once", action="store_true", help="provision one device per station and stop")
+    args = parser.parse_args()
+
+    line = Line(load_bundles(args.bundles), args.results)
+    stations = [Station(port, args.baud, 0.2) for port in args.port]
+    threads = [threading.Thread(target=run_station, args=(s, line, args.poll, args.once)) for s in stations]
+    for t in threads:
+        t.daemon = True
+        t.start()
+    try:
+        while any(t.is_alive() for t in threads):
+            time.sleep(0.5)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Report the static RAM usage per module from the linker map file.
+
+    ram_report.py image_nvm_nocrc.map image_nvm_ram.txt
+
+Lists the bytes each object file places into RAM, split into initialized data,
+zero initialized data (bss), code copied to RAM (RAMFUNC, see smack_sl.h) and
+the remaining RAM sections. The regions reserved for the ROM, the DMA
+descriptors and the stack are listed separately, followed by the RAM left
+between the static data and the stack. The stack high-water mark at runtime
+is exported by the firmware (ram_usage.h).
+
+Run by "make ram_report" (imagebuild.mk), runs with Python 2.7 and 3. Without
+an output file, the report is printed.
+"""
+
+import re
+import sys
+
+RAM_REGIONS = ((0x00020000, 0x00022000), (0x20000000, 0x20002000))
+RESERVED = {
+    ".data_romcode": "ROM data",
+    ".ram2_dma": "DMA descriptors (RAM2)",
+}
+COLUMNS = ("data", "bss", "ramfunc", "other")
+
+OUTPUT_RE = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?(?:\s.*)?$")
+INPUT_RE = re.compile(r"^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.*))?$")
+VALUES_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.*)$")
+ASSIGN_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+(\w+) = ")
+
+
+def fail(message):
+    sys.stderr.write("ram_report: %s\n" % message)
+    sys.exit(1)
+
+
+def in_ram(address):
+    for start, end in RAM_REGIONS:
+        if start <= address < end:
+            return True
+    return False
+
+
+def column(output, name):
+    if output == ".data2" and (".text" in name or ".ramfunc" in name):
+        return "ramfunc"
+    if output in (".data", ".data2"):
+        return "data"
+    if output == ".bss" or name == "COMMON":
+        return "bss"
+    return "other"
+
+
+def module(path):
+    # "obj/foo.o" -> "foo.o", "lib/libx.a(bar.o)" -> "libx.a(bar.o)"
+    return re.split(r"[\\/]", path.strip())[-1]
+
+
+def parse(path):
+    modules = {}
+    reserved = []
+    symbols = {}
+    output = None
+    pending = None
+
+    with open(path) as f:
+        lines = f.read().splitlines()
+    try:
+        lines = lines[lines.index("Linker script and memory map") + 1:]
+    except ValueError:
+        fail("%s is not a GNU ld map file" % path)
+
+    for line in lines:
+        m = OUTPUT_RE.match(line)
+        if m:
+            output = m.group(1)
+            if m.group(2) is not None:
+                address, size = int(m.group(2), 16), int(m.group(3), 16)
+                if output in RESERVED and size and in_ram(address):
+                    reserved.append((RESERVED[output], address, size))
+            pending = None
+            continue
+
+        m = ASSIGN_RE.match(line)
+        if m:
+            symbols[m.group(2)] = int(m.group(1), 16)
+            continue
+
+        m = INPUT_RE.match(line)
+        if m and not line.startswith("  "):
+            pending = m.group(1)
+            if m.group(2) is None:
+                continue
+            values = m.group(2, 3, 4)
+        else:
+            m = VALUES_RE.match(line)
+            if pending is None or not m:
+                pending = None
+                continue
+            values = m.group(1, 2, 3)
+
+        name, pending = pending, None
+        address, size = int(values[0], 16), int(values[1], 16)
+        if size == 0 or not in_ram(address) or output in RESERVED or name.startswith("*"):
+            continue
+        sizes = modules.setdefault(module(values[2]), dict((c, 0) for c in COLUMNS))
+        sizes[column(output, name)] += size
+
+    return modules, reserved, symbols
+
+
+def report(modules, reserved, symbols):
+    lines = []
+    header = "%-32s" % "module" + "".join("%9s" % c for c in COLUMNS) + "%9s" % "total"
+    lines.append(header)
+    lines.append("-" * len(header))
+    totals = dict((c, 0) for c in COLUMNS)
+    ranked = sorted(modules.items(), key=lambda item: (-sum(item[1].values()), item[0]))
+    for name, sizes in ranked:
+        for c in COLUMNS:
+            totals[c] += sizes[c]
+        lines.append("%-32s" % name + "".join("%9d" % sizes[c] for c in COLUMNS) +
+                     "%9d" % sum(sizes.values()))
+    lines.append("-" * len(header))
+    lines.append("%-32s" % "total" + "".join("%9d" % totals[c] for c in COLUMNS) +
+                 "%9d" % sum(totals.values()))
+    lines.append("")
+
+    for name, address, size in reserved:
+        lines.append("%-32s 0x%08x %6d bytes" % (name, address, size))
+    if "__StackLimit" in symbols and "__StackTop" in symbols:
+        size = symbols["__StackTop"] - symbols["__StackLimit"]
+        lines.append("%-32s 0x%08x %6d bytes" % ("stack", symbols["__StackLimit"], size))
+    if "__HeapLimit" in symbols and "__StackLimit" in symbols:
+        free = symbols["__StackLimit"] - symbols["__HeapLimit"]
+        lines.append("%-32s 0x%08x %6d bytes" % ("free below the stack", symbols["__HeapLimit"], free))
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        fail("usage: ram_report.py <input.map> [<output.txt>]")
+
+    text = report(*parse(sys.argv[1]))
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Copyright (c) 2022 Infineon Technologies AG
+#               All rights reserved.
+#               www.infineon.com
+# ============================================================================
+#
+# Redistribution and use of this software only permitted to the extent
+# expressly agreed with Infineon Technologies AG.
+# ============================================================================
+
+"""Convert an event trace (smack_sl/inc/trace.h) into Chrome trace JSON.
+
+    trace_to_chrome.py trace.bin -o trace.json
+
+The input is what the reader app downloads: the replies of data point 0x009A
+(trace_chunk_t, 68 bytes each) one after the other, as read until a chunk with
+count 0 arrives. Records are ordered by their sequence number, duplicates from
+repeated reads are dropped.
+
+Open the output in chrome://tracing or https://ui.perfetto.dev. The power
+states and the motor pulses are shown as durations on their own tracks, the
+other events as instants. A gap in the sequence numbers means the ring was
+overwritten before it was read, it is marked with an instant "lost".
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+CHUNK_HEADER = "<IIB3x"
+RECORD = "<IHH"
+TRACE_CHUNK = 7
+CHUNK_SIZE = struct.calcsize(CHUNK_HEADER) + TRACE_CHUNK * struct.calcsize(RECORD)
+
+EVENTS = ("boot", "state", "auth", "field", "pulse_begin", "pulse_end", "exchange", "request")
+STATES = ("POWER_OFF", "READY_FOR_PASSCODE", "HARVESTING", "HARVESTING_DONE", "IDLE")
+FIELD = ("go", "delay", "move_closer")
+
+TID_STATE = 1
+TID_MOTOR = 2
+TID_EVENTS = 3
+
+
+def load_records(path):
+    """Return {sequence: (time, event, arg)} of all chunks in the file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) % CHUNK_SIZE:
+        sys.exit("%s: size is not a multiple of %d bytes" % (path, CHUNK_SIZE))
+    records = {}
+    for offset in range(0, len(data), CHUNK_SIZE):
+        _, first, count = struct.unpack_from(CHUNK_HEADER, data, offset)
+        pos = offset + struct.calcsize(CHUNK_HEADER)
+        for i in range(min(count, TRACE_CHUNK)):
+            records[first + i] = struct.unpack_from(RECORD, data, pos)
+            pos += struct.calcsize(RECORD)
+    return records
+
+
+def name_of(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def convert(records, clock):
+    """Build the trace event list, times in microseconds from the first record."""
+    events = [
+        {"ph": "M", "name": "thread_name", "pid": 1, "tid": TID_STATE, "args": {"name": "power state"}},
+        {"ph": "M", "name": "thread_name", "pid": 1, "tid": TID_MOTOR, "args": {"name": "motor"}},
+        {"ph": "M", "name": "thread_name", "pid": 1, "tid": TID_EVENTS, "args": {"name": "events"}},
+    ]
+    scale = 1e6 / clock
+    ticks = 0
+    last_time = None
+    last_seq = None
+    state = None
+    pulse = None
+
+    for seq in sorted(records):
+        time, event, arg = records[seq]
+        # the time base wraps after 2^32 ticks, events are assumed to be closer than that
+        if last_time is not None:
+            ticks += (time - last_time) & 0xFFFFFFFF
+        last_time = time
+        ts = ticks * scale
+
+        if last_seq is not None and seq != last_seq + 1:
+            events.append({"ph": "i", "s": "g", "name": "lost", "pid": 1, "tid": TID_EVENTS, "ts": ts,
+                           "args": {"records": seq - last_seq - 1}})
+            state = pulse = None
+        last_seq = seq
+
+        kind = name_of(EVENTS, event)
+        if kind == "state":
+            if state is not None:
+                events.append({"ph": "X", "name": state[0], "pid": 1, "tid": TID_STATE,
+                               "ts": state[1], "dur": ts - state[1]})
+            state = (name_of(STATES, arg), ts)
+        elif kind == "pulse_begin":
+            pulse = (arg, ts)
+        elif kind == "pulse_end":
+            if pulse is not None and pulse[0] == arg:
+                events.append({"ph": "X", "name": "pulse %d" % arg, "pid": 1, "tid": TID_MOTOR,
+                               "ts": pulse[1], "dur": ts - pulse[1]})
+            pulse = None
+        else:
+            if kind == "field":
+                arg = name_of(FIELD, arg)
+            events.append({"ph": "i", "s": "t", "name": kind, "pid": 1, "tid": TID_EVENTS, "ts": ts,
+                           "args": {"arg": arg}})
+
+    if state is not None:
+        events.append({"ph": "X", "name": state[0], "pid": 1, "tid": TID_STATE,
+                       "ts": state[1], "dur": ticks * scale - state[1]})
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace", help="downloaded trace_chunk_t replies")
+    parser.add_argument("-o", "--output", help="JSON file to write (default: stdout)")
+    parser.add_argument("--clock", type=float, default=28e6, help="core clock in Hz (default: 28 MHz)")
+    args = parser.parse_args()
+
+    records = load_records(args.trace)
+    if not records:
+        sys.exit("no records")
+    trace = {"traceEvents": convert(records, args.clock), "displayTimeUnit": "ms"}
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f, indent=1)
+    else:
+        json.dump(trace, sys.stdout, indent=1)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -61,8 +61,7 @@ enum data_point_type_e
     data_point_uint64 = 0x09,   //!< data point is uint64
     data_point_array  = 0x10,   //!< data point is array (byte array of known, fixed length)
     data_point_string = 0x11,   //!< data point is string (array of characters with variable, size limited length)
-    // TODO: data must be encrypted!
-    data_point_encrypt = 0x40,   //!< data exchange must be encrypted
+    data_point_encrypt = 0x40,   //!< data exchange must be encrypted, not served by smack_exchange_handler() (smack_sl dp_crypt.h)
     data_point_write  = 0x80    //!< mark data point as writeable
 };
 
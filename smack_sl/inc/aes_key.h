@@ -0,0 +1,100 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     aes_key.h
+ *
+ * @brief    Tracks the key loaded into the AES unit, so it is only loaded again after a change.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     aes_load_key_ba() writes the key and runs the round key calculation each time, and
+ *           smack_exchange_key_restore() reloads the data exchange key unconditionally. All users of
+ *           the AES unit in this project select their key with aes_key_use(), which skips the load
+ *           if the key is still current. A key is identified by its address, a caller which changes
+ *           the content of a key calls aes_key_invalidate(). smack_exchange_handler() does not
+ *           encrypt, the plain data exchange selects no key.
+ *           The ROM generate_random_number() loads a key of its own, it is called through
+ *           aes_key_random() which invalidates the loaded key and keeps the interrupts disabled
+ *           while the generator runs.
+ *           The key selection and the following calc_aes_ba() calls are not interrupted by other AES
+ *           users: the NFC handlers run at the same priority, any lower priority user disables the
+ *           interrupts around both.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _AES_KEY_H_
+#define _AES_KEY_H_
+
+#include <stdint.h>
+#include "aes_lib.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup aes_key
+ * @{
+ */
+
+/**
+ * @brief Key loads, part of the dp_crypt statistics
+ */
+typedef struct
+{
+    uint32_t loads;             //!< keys loaded into the AES unit
+    uint32_t skipped;           //!< loads skipped because the key was current
+} aes_key_stats_t;
+
+extern aes_key_stats_t aes_key_stats;
+
+
+/**
+ * @brief Make key the current key of the AES unit, loads it only if another one is loaded.
+ * @param key AES-128 key, word aligned
+ */
+extern void aes_key_use(const aes_block_t* key);
+
+/**
+ * @brief Record a key loaded without aes_key_use(), e.g. by smack_exchange_key_set().
+ * @param key AES-128 key now loaded
+ */
+extern void aes_key_loaded(const aes_block_t* key);
+
+/**
+ * @brief Forget the loaded key, the next aes_key_use() loads it again.
+ */
+extern void aes_key_invalidate(void);
+
+/**
+ * @brief Generate a 128 bit random number with the ROM, which uses a key of its own.
+ * @param random receives 4 words
+ */
+extern void aes_key_random(uint32_t* random);
+
+
+/** @} */ /* End of group aes_key */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _AES_KEY_H_ */
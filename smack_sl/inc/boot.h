@@ -0,0 +1,113 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     boot.h
+ *
+ * @brief    Startup profile and lazy initialization of subsystems not needed to answer NFC.
+ *
+ * @version  v1.0
+ * @date     2022-10-12
+ *
+ * @note     _nvm_start() starts the time base first and marks the end of each init step, so the
+ *           profile shows where the time to the first NFC response goes. The time spent in the ROM
+ *           before _nvm_start() is not covered.
+ *           NFC and DAND are initialized first. The data exchange tables and the AES key are set up on
+ *           the first data exchange request (data_exchange_handler()), which records its init time in
+ *           the profile when this happens. The SHC is switched on by the power manager (power.h) when
+ *           a harvesting cycle starts.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _BOOT_H_
+#define _BOOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup boot
+ * @{
+ */
+
+/**
+ * @brief Init steps measured by the profile
+ */
+typedef enum
+{
+    boot_step_ota = 0,          //!< check for a pending update
+    boot_step_nfc = 1,          //!< nfc_init()
+    boot_step_dand = 2,         //!< init_dand()
+    boot_step_tuner = 3,        //!< vclamp tuning table
+    boot_step_image_check = 4,  //!< image CRC check
+    boot_step_status = 5,       //!< charge progress and NDEF tag
+    boot_step_protocol = 6,     //!< protocol state and GPIO setup before the main loop
+    boot_step_exchange = 7,     //!< data exchange tables and AES key, on first use
+    boot_step_count
+} boot_step_t;
+
+/**
+ * @brief Profile exported as data point, all values in core clock ticks
+ */
+typedef struct
+{
+    uint32_t step_ticks[boot_step_count];   //!< duration of each step, 0 if not run (yet)
+    uint32_t ready;                         //!< start of the time base until the main loop is entered
+    uint32_t first_exchange;                //!< start of the time base until the first data exchange request
+} boot_profile_t;
+
+extern boot_profile_t boot_profile;
+
+
+/**
+ * @brief Start the time base and the profile. To be called first in _nvm_start().
+ */
+extern void boot_profile_start(void);
+
+/**
+ * @brief Record the time since the previous mark as duration of a step.
+ * @param step init step which just finished
+ */
+extern void boot_profile_mark(boot_step_t step);
+
+/**
+ * @brief Record the duration of a step initialized on demand.
+ * @param step  init step which just finished
+ * @param start time stamp taken with timebase_now() before the step
+ */
+extern void boot_profile_record(boot_step_t step, uint32_t start);
+
+/**
+ * @brief  Read the time passed since boot_profile_start().
+ * @return elapsed time in core clock ticks
+ */
+extern uint32_t boot_profile_uptime(void);
+
+
+/** @} */ /* End of group boot */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _BOOT_H_ */
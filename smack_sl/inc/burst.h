@@ -0,0 +1,123 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     burst.h
+ *
+ * @brief    Burst read/write of memory blocks as DAND app function.
+ *
+ * @version  v1.0
+ * @date     2022-09-30
+ *
+ * @note     DAND reads and writes one word per frame. For bulk transfers, the reader writes a request
+ *           into the upper half of the mailbox and calls app function ::BURST_APP_FUNCTION:
+ *
+ *           mailbox word | request                      | reply
+ *           -------------|------------------------------|-----------------------------
+ *           +0           | BURST_CMD_READ/_WRITE        | burst_status_t
+ *           +1           | address or BURST_ADDR_NEXT   | address used
+ *           +2           | length in bytes              | length
+ *           +3           | CRC-32 of the data (write)   | CRC-32 of the data
+ *           +4 ...       | data (write)                 | -
+ *
+ *           A read copies the block into the burst window, which is located behind the NDEF area of the
+ *           Type 2 Tag (T2T block ::BURST_WINDOW_BLOCK). The reader then fetches 16 bytes per T2T READ
+ *           frame and checks the CRC in the window header. A write takes the data from the mailbox and
+ *           is only executed if the CRC matches. BURST_ADDR_NEXT continues right behind the previous
+ *           block of the same direction, so a log download only sends the start address once.
+ *           Writes are limited to RAM, NVM is programmed through the assembly buffer only. Reads of the
+ *           device secrets (APARAM secret[], provision.h) and of the persistent page with the passcode
+ *           (nvm_persist.h) are rejected, as are the NVM pages read protected in APARAM nvm_prot_sect.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _BURST_H_
+#define _BURST_H_
+
+#include <stdint.h>
+#include "dand_handler.h"
+#include "ndef_tag.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup burst
+ * @{
+ */
+
+#define BURST_APP_FUNCTION  1               //!< index in APARAM app_prog[]
+#define BURST_MBX_OFFSET    32              //!< first mailbox word used for requests
+#define BURST_MAX_LEN       64              //!< largest block in bytes
+#define BURST_ADDR_NEXT     0xFFFFFFFFUL    //!< continue behind the previous block
+
+#define BURST_CMD_READ      0x42520000UL    //!< 'BR'
+#define BURST_CMD_WRITE     0x42570000UL    //!< 'BW'
+
+#define BURST_WINDOW_BLOCK  NDEF_TAG_EXT_BLOCK  //!< T2T block number of the burst window
+
+/**
+ * @brief Result of a request
+ */
+typedef enum
+{
+    burst_ok = 0,           //!< request executed
+    burst_err_cmd = 1,      //!< unknown command
+    burst_err_len = 2,      //!< length zero or above BURST_MAX_LEN
+    burst_err_addr = 3,     //!< address range not accessible or holding secrets
+    burst_err_crc = 4,      //!< CRC of write data does not match
+    burst_err_busy = 5      //!< direct request while the mailbox pipe owns a slot (mbx_pipe.h)
+} burst_status_t;
+
+/**
+ * @brief Layout of the burst window as seen through T2T READ
+ */
+typedef struct
+{
+    uint32_t address;               //!< address of the first byte
+    uint16_t length;                //!< number of valid bytes in data
+    uint16_t seq;                   //!< incremented with every read, detects stale windows
+    uint32_t crc;                   //!< CRC-32 of data[0..length-1]
+    uint8_t  data[BURST_MAX_LEN];
+} burst_window_t;
+
+
+/**
+ * @brief  DAND app function, executes the request in the mailbox.
+ * @param  mbx DAND mailbox
+ * @return burst_status_t
+ */
+extern uint32_t burst_handler(Mailbox_t* mbx);
+
+/**
+ * @brief  Execute a request at another location, e.g. a mailbox pipe slot (mbx_pipe.h).
+ * @param  req request as at mailbox word BURST_MBX_OFFSET, replaced by the reply
+ * @return burst_status_t
+ */
+extern burst_status_t burst_execute(uint32_t* req);
+
+
+/** @} */ /* End of group burst */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _BURST_H_ */
@@ -0,0 +1,108 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     charge_progress.h
+ *
+ * @brief    Charge progress and ETA status for the reader app.
+ *
+ * @version  v1.0
+ * @date     2022-09-26
+ *
+ * @note     The capacitor level is measured in the notify_tx callback of the data point, only when the
+ *           reader asks for it, with a successive approximation of 8 comparisons. Elapsed time and ETA
+ *           are calculated from it there as well. The SHC holds one threshold at a time: while
+ *           harvesting, the main loop compares through charge_progress_reached() with interrupts
+ *           disabled, before and after harvesting the cached level is returned.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _CHARGE_PROGRESS_H_
+#define _CHARGE_PROGRESS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup charge_progress
+ * @{
+ */
+
+#define CHARGE_PROGRESS_UNKNOWN     0xFFFF      //!< ETA not available
+
+/**
+ * @brief Status exported as data point
+ */
+typedef struct
+{
+    uint16_t level;         //!< capacitor level in SHC digits (1000mV ~ 1024 digits)
+    uint16_t threshold;     //!< level needed to drive the motor
+    uint16_t elapsed_ms;    //!< time since harvesting started
+    uint16_t eta_ms;        //!< estimated time until the threshold is reached
+    uint8_t  state;         //!< Power_State_enum_t
+    uint8_t  pulse;         //!< index of the current motor pulse, 0 before the actuation
+    uint8_t  lock_phase;    //!< Lock_State_enum_t
+    uint8_t  rfu;
+} charge_progress_t;
+
+extern charge_progress_t charge_progress;
+
+
+/**
+ * @brief Initialize the status with the lock state stored in NVM.
+ */
+extern void charge_progress_init(void);
+
+/**
+ * @brief Start timing of a harvesting cycle and take the first level sample.
+ */
+extern void charge_progress_start(void);
+
+/**
+ * @brief  Compare the capacitor level with the motor threshold, ends the measurements when reached.
+ *         To be called from the main loop while harvesting.
+ * @return true if the threshold is reached
+ */
+extern bool charge_progress_reached(void);
+
+/**
+ * @brief Update pulse index and lock phase during actuation.
+ * @param pulse      index of the motor pulse (1 based), 0 when not driving
+ * @param lock_phase Lock_State_enum_t
+ */
+extern void charge_progress_actuate(uint8_t pulse, uint8_t lock_phase);
+
+/**
+ * @brief notify_tx callback of the status data point, refreshes the time based fields.
+ * @param data_point_id id of the data point being read
+ */
+extern void charge_progress_notify_tx(uint16_t data_point_id);
+
+
+/** @} */ /* End of group charge_progress */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _CHARGE_PROGRESS_H_ */
@@ -0,0 +1,87 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     crc32.h
+ *
+ * @brief    CRC-32 (IEEE 802.3, as used by zlib) for transfer and image checks.
+ *
+ * @version  v1.0
+ * @date     2022-09-30
+ *
+ * @note     Table driven with 4 bit steps, so the table only needs 64 bytes of NVM.
+ *           The calculation may be split into several calls:
+ *           crc32_final(crc32_update(crc32_update(CRC32_INIT, a, n), b, m)) equals the CRC of a|b.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _CRC32_H_
+#define _CRC32_H_
+
+#include <stdint.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup crc32
+ * @{
+ */
+
+#define CRC32_INIT  0xFFFFFFFFUL    //!< start value of a running CRC
+
+/**
+ * @brief  Add data to a running CRC.
+ * @param  crc    running CRC, CRC32_INIT for the first block
+ * @param  data   data to add
+ * @param  length number of bytes
+ * @return updated running CRC
+ */
+extern uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length);
+
+/**
+ * @brief  Finish a running CRC.
+ * @param  crc running CRC
+ * @return CRC-32 value
+ */
+static inline uint32_t crc32_final(uint32_t crc)
+{
+    return ~crc;
+}
+
+/**
+ * @brief  Calculate the CRC-32 of a single block.
+ * @param  data   data
+ * @param  length number of bytes
+ * @return CRC-32 value
+ */
+static inline uint32_t crc32(const void* data, uint32_t length)
+{
+    return crc32_final(crc32_update(CRC32_INIT, data, length));
+}
+
+
+/** @} */ /* End of group crc32 */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _CRC32_H_ */
@@ -0,0 +1,132 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     dp_chunk.h
+ *
+ * @brief    Chunked transfer of objects larger than a data point.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     A data point of the data exchange library holds at most 255 bytes and has to fit into a
+ *           single reply. Objects such as logs or certificates are listed as dp_chunk_object_t instead
+ *           and transferred in chunks of up to DP_CHUNK_MAX_LEN (208) bytes, addressed by offset. The
+ *           reader writes a request into the mailbox above the state machine words and calls app
+ *           function ::DP_CHUNK_APP_FUNCTION:
+ *
+ *           word | DP_CHUNK_CMD_INFO | DP_CHUNK_CMD_READ      | DP_CHUNK_CMD_WRITE     | DP_CHUNK_CMD_COMMIT
+ *           ---- | ----------------- | ---------------------- | ---------------------- | -------------------
+ *           +0   | cmd | id          | cmd | id               | cmd | id               | cmd | id
+ *           +1   | -> size           | offset                 | offset -> next         | length
+ *           +2   | -> next           | length -> length       | length                 | -
+ *           +3   | -> object CRC     | -> CRC of the chunk    | CRC of the chunk       | object CRC
+ *           +4.. | -                 | -> data                | data                   | -
+ *
+ *           Word +0 of the reply is the dp_chunk_status_t, "->" marks the reply values. CRCs are
+ *           CRC-32 (crc32.h). Reads have no state: the reader reads from any offset until a chunk
+ *           comes back shorter than requested and compares the object CRC of DP_CHUNK_CMD_INFO.
+ *           A write starts at offset 0, the following chunks continue at or before next, the end of
+ *           the data written so far, so a transfer is resumed from next (also returned by
+ *           DP_CHUNK_CMD_INFO) after a lost reply or a change of reader. DP_CHUNK_CMD_COMMIT checks
+ *           the CRC of the whole object and calls notify_rx, the content is undefined until then.
+ *           One write transfer is open at a time. The CRCs over the whole object are calculated in
+ *           the NFC handler, about 20 core clock ticks per byte.
+ *           Chunk requests may also be queued in the mailbox pipe (mbx_pipe.h), with shorter chunks.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _DP_CHUNK_H_
+#define _DP_CHUNK_H_
+
+#include <stdint.h>
+#include "dand_handler.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup dp_chunk
+ * @{
+ */
+
+#define DP_CHUNK_APP_FUNCTION   5               //!< index in APARAM app_prog[]
+#define DP_CHUNK_MBX_OFFSET     8               //!< first mailbox word used for requests, below are the state machine words
+#define DP_CHUNK_HEADER_WORDS   4
+#define DP_CHUNK_MAX_LEN        ((MAILBOX_SIZE - DP_CHUNK_MBX_OFFSET - DP_CHUNK_HEADER_WORDS) * 4)  //!< largest chunk in bytes
+
+#define DP_CHUNK_CMD_INFO       0x43490000UL    //!< 'CI', object id in the lower half
+#define DP_CHUNK_CMD_READ       0x43520000UL    //!< 'CR'
+#define DP_CHUNK_CMD_WRITE      0x43570000UL    //!< 'CW'
+#define DP_CHUNK_CMD_COMMIT     0x43430000UL    //!< 'CC'
+#define DP_CHUNK_CMD_MASK       0xFFFF0000UL
+#define DP_CHUNK_IS_CMD(cmd_)   (((cmd_) >> 24) == (DP_CHUNK_CMD_INFO >> 24))
+
+#define DP_CHUNK_WRITE          0x01U           //!< dp_chunk_object_t.flags: object may be written
+
+/**
+ * @brief Result of a request
+ */
+typedef enum
+{
+    dp_chunk_ok = 0,            //!< request executed
+    dp_chunk_err_cmd = 1,       //!< unknown command
+    dp_chunk_err_id = 2,        //!< no object with this id
+    dp_chunk_err_access = 3,    //!< object is read only
+    dp_chunk_err_range = 4,     //!< offset or length outside the object or above the chunk size
+    dp_chunk_err_crc = 5,       //!< CRC of the chunk or the object mismatch
+    dp_chunk_err_order = 6,     //!< write beyond next, or commit of another length or without transfer
+    dp_chunk_err_busy = 7       //!< direct request while the mailbox pipe owns a slot (mbx_pipe.h)
+} dp_chunk_status_t;
+
+/**
+ * @brief Entry in the list of objects, sorted by id
+ */
+typedef struct
+{
+    uint16_t id;                        //!< unique id, separate from the data point ids
+    uint8_t  flags;                     //!< DP_CHUNK_WRITE
+    uint32_t size;                      //!< size of the buffer in bytes
+    void*    value;                     //!< buffer
+    uint32_t* used;                     //!< bytes in use, set by a commit, NULL if always size
+    void     (*notify_rx)(uint16_t);    //!< if set, called with id after a commit
+    void     (*notify_tx)(uint16_t);    //!< if set, called with id before DP_CHUNK_CMD_INFO
+} dp_chunk_object_t;
+
+
+/**
+ * @brief  Execute a request.
+ * @param  table      objects, sorted by id
+ * @param  count      number of objects
+ * @param  req        request as at mailbox word DP_CHUNK_MBX_OFFSET, replaced by the reply
+ * @param  max_length largest chunk fitting behind req
+ * @return dp_chunk_status_t
+ */
+extern dp_chunk_status_t dp_chunk_execute(const dp_chunk_object_t* table, uint16_t count, uint32_t* req,
+                                          uint32_t max_length);
+
+
+/** @} */ /* End of group dp_chunk */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _DP_CHUNK_H_ */
@@ -0,0 +1,176 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     dp_crypt.h
+ *
+ * @brief    Encrypted and authenticated exchange of the data points marked data_point_encrypt.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     smack_exchange_handler() ignores data_point_encrypt, so these data points are kept in a
+ *           list of their own which only this module serves. The reader writes a request into the
+ *           upper half of the mailbox and calls app function ::DP_CRYPT_APP_FUNCTION:
+ *
+ *           word         | request                       | reply
+ *           ------------ | ----------------------------- | -----------------------------
+ *           +0           | DP_CRYPT_CMD_READ/_WRITE | id | dp_crypt_status_t
+ *           +1           | counter                       | counter
+ *           +2, +3       | session (write)               | session
+ *           +4           | length in bytes (write)       | length in bytes (read)
+ *           +5, +6       | tag (write)                   | tag (read)
+ *           +7...        | encrypted value (write)       | encrypted value (read)
+ *
+ *           The value is protected with AES-128 CCM (RFC 3610) with an 8 byte tag, on the hardware
+ *           AES with a single key schedule, as CCM only encrypts. The additional authenticated data
+ *           are the request words +0...+4, the 13 byte nonce is the direction (0 reader to tag, 1 tag
+ *           to reader), the 64 bit session and the counter, each little endian.
+ *           The session is a random number drawn at the first data exchange after power up and
+ *           returned in every reply, the counter is chosen by the reader and has to increase with
+ *           every request of a session, starting above 0. Every tap powers the tag up again, so the
+ *           session is 64 bit wide: a repeated session, and with it a repeated nonce, is not to be
+ *           expected within the lifetime of a key. Old requests are not accepted again. Values are in
+ *           memory byte order, strings without the terminating zero, their buffer has room for
+ *           length + 1 bytes as for the data exchange.
+ *           The handler runs in the NFC interrupt like the data exchange, the key is selected with
+ *           aes_key_use() (aes_key.h). With DP_CRYPT_BENCHMARK defined, dp_crypt_benchmark() measures
+ *           the time of sealing and opening values of DP_CRYPT_BENCH_LENGTHS lengths during startup.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _DP_CRYPT_H_
+#define _DP_CRYPT_H_
+
+#include <stdint.h>
+#include "dand_handler.h"
+#include "smack_exchange.h"
+#include "aes_key.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup dp_crypt
+ * @{
+ */
+
+#define DP_CRYPT_APP_FUNCTION   4               //!< index in APARAM app_prog[]
+#define DP_CRYPT_MBX_OFFSET     32              //!< first mailbox word used for requests
+#define DP_CRYPT_HEADER_WORDS   7
+#define DP_CRYPT_MAX_LEN        ((MAILBOX_SIZE - DP_CRYPT_MBX_OFFSET - DP_CRYPT_HEADER_WORDS) * 4)  //!< largest value in bytes
+#define DP_CRYPT_TAG_LEN        8               //!< CCM tag bytes
+#define DP_CRYPT_NONCE_LEN      13              //!< CCM nonce bytes, 2 byte length field
+
+#define DP_CRYPT_CMD_READ       0x45520000UL    //!< 'ER', data point id in the lower half
+#define DP_CRYPT_CMD_WRITE      0x45570000UL    //!< 'EW'
+#define DP_CRYPT_CMD_MASK       0xFFFF0000UL
+
+#define DP_CRYPT_BENCH_LENGTHS  5               //!< value lengths measured, 4 bytes to DP_CRYPT_MAX_LEN
+
+/**
+ * @brief Result of a request
+ */
+typedef enum
+{
+    dp_crypt_ok = 0,            //!< request executed
+    dp_crypt_err_cmd = 1,       //!< unknown command
+    dp_crypt_err_id = 2,        //!< no encrypted data point with this id
+    dp_crypt_err_access = 3,    //!< data point is read only
+    dp_crypt_err_len = 4,       //!< length does not fit the data point or the mailbox
+    dp_crypt_err_session = 5,   //!< session is not the current one
+    dp_crypt_err_replay = 6,    //!< counter did not increase
+    dp_crypt_err_auth = 7       //!< tag mismatch, nothing written
+} dp_crypt_status_t;
+
+/**
+ * @brief Counters exported as data point
+ */
+typedef struct
+{
+    uint32_t requests;          //!< requests handled
+    uint16_t auth_failures;     //!< writes rejected by the tag
+    uint16_t replays;           //!< requests rejected by session or counter
+    aes_key_stats_t key;        //!< key loads of all AES users, copied when read
+} dp_crypt_stats_t;
+
+/**
+ * @brief Time of a value length in core clock ticks, including one time base read
+ */
+typedef struct
+{
+    uint16_t length;            //!< value bytes
+    uint16_t copy;              //!< copying the value only, for comparison
+    uint16_t seal;              //!< tag and encryption
+    uint16_t open;              //!< decryption and tag check
+} dp_crypt_bench_entry_t;
+
+/**
+ * @brief Benchmark result exported as data point
+ */
+typedef struct
+{
+    uint16_t key_load;          //!< aes_key_use() with another key loaded
+    uint16_t key_skip;          //!< aes_key_use() with the key current
+    dp_crypt_bench_entry_t entry[DP_CRYPT_BENCH_LENGTHS];
+} dp_crypt_bench_t;
+
+extern dp_crypt_stats_t dp_crypt_stats;
+
+
+/**
+ * @brief Set the encrypted data points and the key, start a new session. Called by vars_init().
+ * @param table data points, sorted by id, not copied
+ * @param count number of data points
+ * @param key   AES-128 key, word aligned, not copied
+ */
+extern void dp_crypt_init(const data_point_entry_t* table, uint16_t count, const aes_block_t* key);
+
+/**
+ * @brief  Execute the request in the mailbox, called by the app function in smack_dataexchange.c.
+ * @param  mbx DAND mailbox
+ * @return dp_crypt_status_t
+ */
+extern dp_crypt_status_t dp_crypt_handler(Mailbox_t* mbx);
+
+/**
+ * @brief notify_tx of the statistics data point, copies the key statistics.
+ */
+extern void dp_crypt_notify_tx(uint16_t data_point_id);
+
+#ifdef DP_CRYPT_BENCHMARK
+
+extern dp_crypt_bench_t dp_crypt_bench;
+
+/**
+ * @brief Measure key selection and the sealing and opening of values, during startup.
+ */
+extern void dp_crypt_benchmark(void);
+
+#endif /* DP_CRYPT_BENCHMARK */
+
+
+/** @} */ /* End of group dp_crypt */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _DP_CRYPT_H_ */
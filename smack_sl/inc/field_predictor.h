@@ -0,0 +1,103 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     field_predictor.h
+ *
+ * @brief    Go/no-go decision before the motor is driven.
+ *
+ * @version  v1.0
+ * @date     2022-09-23
+ *
+ * @note     Driving the motor needs one capacitor recharge per pulse. If the field is too weak to
+ *           deliver them in time, the lock ends up half way and the whole sequence has to be repeated.
+ *           The predictor samples RSSI and VCCCA, takes the charge time the vclamp tuner measured in this
+ *           session, or the one recorded for this field strength if the capacitor was charged already,
+ *           and estimates the time the actuation will take. Based on this, it decides to start, to wait
+ *           for the supply to settle or to ask the user to move the reader closer. The limits below are
+ *           starting points, the statistics data point is meant for tuning them on the bench.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _FIELD_PREDICTOR_H_
+#define _FIELD_PREDICTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup field_predictor
+ * @{
+ */
+
+#define FIELD_PREDICTOR_SAMPLES         4       //!< number of ADC samples averaged per measurement
+#define FIELD_PREDICTOR_RSSI_MIN        0x0080  //!< below this field strength the actuation is not started
+#define FIELD_PREDICTOR_VCCCA_MIN       0x0200  //!< below this supply level the decision is delayed
+#define FIELD_PREDICTOR_BUDGET_MS       4000    //!< longest acceptable predicted actuation time
+#define FIELD_PREDICTOR_PULSE_SHARE     25      //!< share of a full charge needed per motor pulse in %
+#define FIELD_PREDICTOR_MAX_DELAYS      8       //!< delays before a low supply is reported as weak field
+#define FIELD_PREDICTOR_RETRY_MS        50      //!< wait time before the next evaluation
+
+/**
+ * @brief Outcome of an evaluation
+ */
+typedef enum
+{
+    field_decision_go = 0,          //!< start the actuation
+    field_decision_delay = 1,       //!< supply not settled, evaluate again later
+    field_decision_move_closer = 2  //!< field too weak, reader has to move closer
+} field_decision_t;
+
+/**
+ * @brief Input and result of the latest evaluation plus session counters, exported as data point
+ */
+typedef struct
+{
+    uint16_t rssi;          //!< averaged field strength
+    uint16_t vccca;         //!< averaged supply level
+    uint16_t charge_ms;     //!< full charge time of this session, else recorded for this field strength
+    uint16_t predicted_ms;  //!< predicted actuation time
+    uint8_t  decision;      //!< field_decision_t of the latest evaluation
+    uint8_t  delays;        //!< consecutive delays in the current attempt
+    uint16_t go_count;      //!< number of go decisions in this session
+    uint16_t delay_count;   //!< number of delay decisions in this session
+    uint16_t weak_count;    //!< number of move closer decisions in this session
+} field_predictor_stats_t;
+
+extern field_predictor_stats_t field_predictor_stats;
+
+
+/**
+ * @brief  Measure the field and decide whether the actuation shall be started.
+ * @return decision, see field_decision_t
+ */
+extern field_decision_t field_predictor_evaluate(void);
+
+
+/** @} */ /* End of group field_predictor */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _FIELD_PREDICTOR_H_ */
@@ -0,0 +1,113 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     image_check.h
+ *
+ * @brief    Integrity check of the NVM image against the CRC stamped into the version section.
+ *
+ * @version  v1.0
+ * @date     2022-10-10
+ *
+ * @note     scripts/image_crc_stamp.py stamps the CRC-32 of the range IMAGE_CHECK_START to
+ *           IMAGE_CHECK_END into version.crc after linking, if the SDK build is run with IMAGE_CRC
+ *           set. Otherwise version.crc keeps its initial 0 and the check is skipped
+ *           (image_check_unstamped). This is the same range and CRC as the
+ *           image CRC of a firmware update (ota.h). The device data from IMAGE_DEVICE_START to
+ *           IMAGE_DEVICE_END is skipped, it differs from device to device.
+ *           Startup only compares version.crc with the CRC verified last, which is cached in the
+ *           persistent page. Flashing or updating a different image changes version.crc, so the
+ *           cache then misses and the image is checked in steps of IMAGE_CHECK_STEP bytes while
+ *           the main loop waits for the reader. A successful check is written to the cache.
+ *           The CLUART CRC unit behind reset_CRC_peripheral() only processes received NFC frames
+ *           and cannot be fed from memory, the check uses crc32.c.
+ *           Define IMAGE_CHECK_BLOCKING to check the complete image during startup instead, e.g. to
+ *           measure the boot time it costs (image_check_stats_t.boot_ticks).
+ */
+
+/*lint -save -e960 */
+
+#ifndef _IMAGE_CHECK_H_
+#define _IMAGE_CHECK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup image_check
+ * @{
+ */
+
+#define IMAGE_CHECK_START   0x00010400UL        //!< first byte covered by the image CRC (APARAM)
+#define IMAGE_CHECK_END     0x0001D180UL        //!< end of the image, start of the OTA staging area
+#define IMAGE_DEVICE_START  0x00010600UL        //!< APARAM secret[] and public[], written per device (provision.h)
+#define IMAGE_DEVICE_END    0x00010800UL        //!< end of the device data, not covered by the image CRC
+#define IMAGE_CHECK_STEP    256                 //!< bytes checked per call of image_check_step()
+
+/**
+ * @brief Result of the check
+ */
+typedef enum
+{
+    image_check_unstamped = 0,  //!< version.crc is 0 or erased, image not stamped by the build, not checked
+    image_check_running = 1,    //!< check in progress
+    image_check_ok = 2,         //!< CRC matches
+    image_check_cached = 3,     //!< CRC matched at an earlier startup
+    image_check_failed = 4      //!< CRC mismatch, image corrupted
+} image_check_status_t;
+
+/**
+ * @brief Status exported as data point
+ */
+typedef struct
+{
+    uint32_t expected;      //!< CRC stamped into version.crc
+    uint32_t calculated;    //!< CRC of the image, valid after the check is done
+    uint32_t boot_ticks;    //!< time spent in image_check_init() during startup
+    uint32_t check_ticks;   //!< time spent in image_check_step() in total
+    uint16_t offset;        //!< bytes checked so far
+    uint8_t  status;        //!< image_check_status_t
+    uint8_t  rfu;
+} image_check_stats_t;
+
+extern image_check_stats_t image_check_stats;
+
+
+/**
+ * @brief Start the check at startup, needs the time base.
+ */
+extern void image_check_init(void);
+
+/**
+ * @brief  Check the next IMAGE_CHECK_STEP bytes. To be called while the main loop is idle.
+ * @return true while the check is still running
+ */
+extern bool image_check_step(void);
+
+
+/** @} */ /* End of group image_check */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _IMAGE_CHECK_H_ */
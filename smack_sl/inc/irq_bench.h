@@ -0,0 +1,116 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     irq_bench.h
+ *
+ * @brief    Entry latency of the interrupt routes through the ROM dispatch.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     Built with IRQ_BENCHMARK defined. irq_bench_run() measures IRQ_BENCH_SAMPLES entries per
+ *           route with the time base (timebase.h): from the trigger to the first time stamp in the
+ *           APARAM handler, minus the cost of reading the time base. All routes end in
+ *           irq_bench_handler() as timer5_hand_addr (irq_map.h):
+ *           - irq_route_evbus: event bus line 7 pended by software, source TIMER5_IRQ_HAND.
+ *           - irq_route_hp: HP matrix line IRQ_BENCH_LINE pended by software, source PM5_IRQ_HAND.
+ *           - irq_route_hp_timer: the same line raised by system timer IRQ_BENCH_CHANNEL, measured from
+ *             the call of sys_tim_singleshot() plus IRQ_BENCH_PERIOD, the route of the motor timer. The
+ *             setup of the timer by the helper is included.
+ *           The result is returned by data point 0x009E.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _IRQ_BENCH_H_
+#define _IRQ_BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup irq_bench
+ * @{
+ */
+
+#define IRQ_BENCH_SAMPLES   32          //!< entries measured per route
+#define IRQ_BENCH_LINE      13          //!< HP matrix line, IRQ_MAP_HP13
+#define IRQ_BENCH_CHANNEL   5           //!< system timer, PM5_IRQ_HAND
+#define IRQ_BENCH_PERIOD    2000        //!< timer period in core clock ticks
+
+/**
+ * @brief Measured routes
+ */
+typedef enum
+{
+    irq_route_evbus = 0,                //!< event bus, software pend
+    irq_route_hp = 1,                   //!< HP matrix, software pend
+    irq_route_hp_timer = 2,             //!< HP matrix, system timer
+    irq_route_count = 3
+} irq_route_t;
+
+/**
+ * @brief Latency of a route in core clock ticks
+ */
+typedef struct
+{
+    uint16_t min;
+    uint16_t max;
+    uint32_t total;                     //!< sum of all samples, divided by samples gives the mean
+} irq_bench_route_t;
+
+/**
+ * @brief Benchmark result exported as data point
+ */
+typedef struct
+{
+    uint16_t samples;                   //!< samples per route
+    uint16_t overhead;                  //!< ticks of a time base read, already subtracted
+    irq_bench_route_t route[irq_route_count];
+} irq_bench_t;
+
+
+#ifdef IRQ_BENCHMARK
+
+extern irq_bench_t irq_bench;
+
+/**
+ * @brief Measure all routes, interrupts must be enabled.
+ */
+extern void irq_bench_run(void);
+
+/**
+ * @brief Handler of all routes in APARAM (timer5_hand_addr).
+ */
+extern void irq_bench_handler(void);
+
+#endif /* IRQ_BENCHMARK */
+
+
+/** @} */ /* End of group irq_bench */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _IRQ_BENCH_H_ */
@@ -0,0 +1,127 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     irq_map.h
+ *
+ * @brief    Routing of the interrupt sources to the NVIC lines and their priorities.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     All interrupts enter through the ROM vector table. The six HP matrix lines (NVIC 9...14)
+ *           call the APARAM handler of the source in hp_irqN_cfg (handlers.h: UART_IRQ_HAND ...,
+ *           PMn_IRQ_HAND is system timer n and calls timern_hand_addr), the event bus lines (NVIC
+ *           1...8) the handler of the source in evbus_handlerN_source. Unused lines keep IRQ_MAP_NONE.
+ *           The table below is the single place where sources are assigned to lines, sl_aparam.c
+ *           takes the APARAM values from it and irq_map_init() sets the NVIC priorities, 0 is the
+ *           highest, 3 the lowest. The modules configure their peripheral for the line given here
+ *           (LOG_UART_IRQ, PROVISION_UART_IRQ, SPI_IRQ, MOTOR_TIMER_LINE).
+ *           The NFC interface (IRQ 0) and the field loss (IRQ 16) have NVIC lines of their own, the
+ *           comparator is polled with shc_compare() and has no interrupt.
+ *           With IRQ_BENCHMARK defined, irq_bench.h measures the entry latency of the routes.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _IRQ_MAP_H_
+#define _IRQ_MAP_H_
+
+#include <stdint.h>
+#include "handlers.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup irq_map
+ * @{
+ */
+
+// features needing another one, set here so every user of the table sees the same routing
+#if defined(SPI_BENCHMARK) && !defined(SPI_DRIVER)
+#define SPI_DRIVER
+#endif
+
+#define IRQ_MAP_NONE            0xffffffffUL    //!< APARAM value of an unused line
+#define IRQ_MAP_LOWEST          3               //!< priority of the lines without entry
+
+//                              source                  priority    user
+#if defined(UART_LOG) || defined(UART_PROVISION)
+#define IRQ_MAP_HP9             UART_IRQ_HAND
+#define IRQ_MAP_HP9_PRIO                                2           // log.h, provision.h
+#endif
+#ifdef SPI_DRIVER
+#define IRQ_MAP_HP10            SSP_IRQ_HAND
+#define IRQ_MAP_HP10_PRIO                               1           // spi.h, 8 entry FIFO
+#endif
+#ifdef IRQ_BENCHMARK
+#define IRQ_MAP_HP13            PM5_IRQ_HAND
+#define IRQ_MAP_HP13_PRIO                               0           // irq_bench.h, system timer 5
+#endif
+#define IRQ_MAP_HP14            PM0_IRQ_HAND
+#define IRQ_MAP_HP14_PRIO                               1           // smack_sl.h motor charge wait, system timer 0
+#ifdef IRQ_BENCHMARK
+#define IRQ_MAP_EVBUS7          TIMER5_IRQ_HAND
+#define IRQ_MAP_EVBUS7_PRIO                             0           // irq_bench.h, pended by software
+#endif
+#define IRQ_MAP_EVBUS8          TIMER4_IRQ_HAND
+#define IRQ_MAP_EVBUS8_PRIO                             3           // smack_dataexchange.h bottom half, pended by software
+
+// unused lines
+#ifndef IRQ_MAP_HP9
+#define IRQ_MAP_HP9             IRQ_MAP_NONE
+#define IRQ_MAP_HP9_PRIO        IRQ_MAP_LOWEST
+#endif
+#ifndef IRQ_MAP_HP10
+#define IRQ_MAP_HP10            IRQ_MAP_NONE
+#define IRQ_MAP_HP10_PRIO       IRQ_MAP_LOWEST
+#endif
+#ifndef IRQ_MAP_HP11
+#define IRQ_MAP_HP11            IRQ_MAP_NONE
+#define IRQ_MAP_HP11_PRIO       IRQ_MAP_LOWEST
+#endif
+#ifndef IRQ_MAP_HP12
+#define IRQ_MAP_HP12            IRQ_MAP_NONE
+#define IRQ_MAP_HP12_PRIO       IRQ_MAP_LOWEST
+#endif
+#ifndef IRQ_MAP_HP13
+#define IRQ_MAP_HP13            IRQ_MAP_NONE
+#define IRQ_MAP_HP13_PRIO       IRQ_MAP_LOWEST
+#endif
+#ifndef IRQ_MAP_EVBUS7
+#define IRQ_MAP_EVBUS7          IRQ_MAP_NONE
+#define IRQ_MAP_EVBUS7_PRIO     IRQ_MAP_LOWEST
+#endif
+
+
+/**
+ * @brief Set the NVIC priorities of the HP matrix and event bus lines and enable the bottom half line
+ *        (IRQ_MAP_EVBUS8). To be called during startup, before nfc_init().
+ */
+extern void irq_map_init(void);
+
+
+/** @} */ /* End of group irq_map */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _IRQ_MAP_H_ */
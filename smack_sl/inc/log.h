@@ -0,0 +1,140 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     log.h
+ *
+ * @brief    Binary debug log on the UART, formatted on the host.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     LOG0() ... LOG3() do not format anything on the target. The format string is placed in
+ *           the section .log_fmt, which the linker keeps in the ELF file but not in the image
+ *           (Linker_config.ld). Its offset in that section is the message id. A call writes the id
+ *           and the raw 32 bit arguments into a RAM ring of LOG_SIZE words, the UART TX interrupt
+ *           drains the ring through the TX FIFO. A call costs some 20 cycles with interrupts masked,
+ *           the first message after the ring ran empty also fills the FIFO.
+ *           Each message is sent as little endian words: a header (id in bits 0..15, argument
+ *           count in bits 16..23, LOG_SYNC in bits 24..31) followed by the arguments. Messages
+ *           which do not fit into the ring are dropped and reported by a message with id
+ *           LOG_ID_DROPPED and the number of messages lost.
+ *           scripts/log_decode.py reads the format strings from the ELF file of the build and
+ *           prints the messages received from the UART.
+ *           The log is only built in with UART_LOG defined, otherwise the macros expand to nothing.
+ *           It takes the UART handler in APARAM (matrix IRQ LOG_UART_IRQ), the UART power domain
+ *           while messages are pending and LOG_SIZE * 4 bytes RAM. The UART uses the pins of the ROM UART.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup log
+ * @{
+ */
+
+#ifndef LOG_SIZE
+#define LOG_SIZE            64          //!< ring size in 32 bit words, power of 2
+#endif
+#ifndef LOG_BAUDRATE
+#define LOG_BAUDRATE        115200UL    //!< UART baudrate
+#endif
+#define LOG_UART_IRQ        9           //!< HP matrix IRQ the UART is routed to (9...14)
+#define LOG_SYNC            0xA5        //!< top byte of every header word
+#define LOG_ID_DROPPED      0xFFFF      //!< id of the message reporting dropped messages, argument: count
+
+#ifdef UART_LOG
+
+/**
+ * @brief Statistics of the log
+ */
+typedef struct
+{
+    uint32_t messages;                  //!< messages written into the ring
+    uint32_t dropped;                   //!< messages dropped because the ring was full
+} log_stats_t;
+
+extern log_stats_t log_stats;
+
+
+/**
+ * @brief Configure the UART for the log and enable the TX interrupt.
+ */
+extern void log_init(void);
+
+/**
+ * @brief Write a message into the ring, use the LOGn() macros instead.
+ * @param header header word with id and argument count
+ * @param args   arguments, count as in header
+ */
+extern void log_write(uint32_t header, const uint32_t* args);
+
+/**
+ * @brief Release the UART power domain once the log is sent, called from the main loop.
+ *        The next message switches the UART on again.
+ */
+extern void log_poll(void);
+
+/**
+ * @brief UART handler in APARAM, moves the ring into the TX FIFO.
+ */
+extern void log_uart_handler(void);
+
+#define LOG_HEADER(fmt_, count_)  ((LOG_SYNC << 24) | ((count_) << 16) | ((uint32_t) (fmt_) & 0xFFFF))
+
+/* the format string goes to .log_fmt, its address there is the id */
+#define LOG_MSG(fmt, count, ...)                                                                \
+    do                                                                                          \
+    {                                                                                           \
+        static const char log_fmt_[] __attribute__((section(".log_fmt"), used)) = fmt;          \
+        const uint32_t log_args_[(count) + 1] = { __VA_ARGS__ };                                \
+        log_write(LOG_HEADER(log_fmt_, count), log_args_);                                      \
+    } while (0)
+
+#define LOG0(fmt)               LOG_MSG(fmt, 0, 0)
+#define LOG1(fmt, a)            LOG_MSG(fmt, 1, (uint32_t) (a))
+#define LOG2(fmt, a, b)         LOG_MSG(fmt, 2, (uint32_t) (a), (uint32_t) (b))
+#define LOG3(fmt, a, b, c)      LOG_MSG(fmt, 3, (uint32_t) (a), (uint32_t) (b), (uint32_t) (c))
+
+#else
+
+#define LOG0(fmt)               do { } while (0)
+#define LOG1(fmt, a)            do { (void) (a); } while (0)
+#define LOG2(fmt, a, b)         do { (void) (a); (void) (b); } while (0)
+#define LOG3(fmt, a, b, c)      do { (void) (a); (void) (b); (void) (c); } while (0)
+
+#endif /* UART_LOG */
+
+
+/** @} */ /* End of group log */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _LOG_H_ */
@@ -0,0 +1,125 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     mbx_pipe.h
+ *
+ * @brief    Two slot mailbox, the reader writes the next request while the previous one executes.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     With burst_handler() and ota_handler() the reader has to wait for the reply of a request
+ *           before it may write the next one into the mailbox. The pipe splits mailbox words
+ *           PIPE_MBX_OFFSET...63 into PIPE_SLOTS slots of PIPE_SLOT_WORDS words. Word 0 of a slot is
+ *           the header, the following words hold a burst, OTA or chunk request in the layout of
+ *           burst.h, ota.h and dp_chunk.h, which is replaced by the reply in place:
+ *
+ *           header bits  | 31:24         | 23:16 | 15:8                           | 7:0
+ *           ------------ | ------------- | ----- | ------------------------------ | --------
+ *           reader       | PIPE_READY    | 0     | 0                              | sequence
+ *           firmware     | PIPE_BUSY     | 0     | 0                              | sequence
+ *           firmware     | PIPE_DONE     | 0     | status of the request          | sequence
+ *
+ *           The state in the header is the ownership flag: a slot in PIPE_READY or PIPE_BUSY belongs
+ *           to the firmware, any other one to the reader. The reader writes the request first and the
+ *           header last, then calls app function ::PIPE_APP_FUNCTION. The firmware writes the reply
+ *           first and the header last. The app function only pends the bottom half
+ *           (smack_dataexchange.h), so the NFC reply is sent right away and the reader fills the other
+ *           slot while the request executes. The bottom half runs the ready slots in sequence order,
+ *           a missing sequence number (the reader restarted) is skipped to the oldest ready slot.
+ *
+ *           The pipe uses the words of the burst, OTA and chunk requests, a reader uses either the pipe
+ *           or the direct app functions, and the data exchange protocol only while no slot is ready.
+ *           The direct app functions reply with their busy status while a slot is owned by the firmware,
+ *           they would change the state the bottom half works on. Each app function call counts one
+ *           request in perf.h, the executed slots are counted here.
+ *           Burst reads are not pipelined behind each other, both replies point to the same window.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _MBX_PIPE_H_
+#define _MBX_PIPE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dand_handler.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup mbx_pipe
+ * @{
+ */
+
+#define PIPE_APP_FUNCTION   3               //!< index in APARAM app_prog[]
+#define PIPE_MBX_OFFSET     8               //!< first mailbox word of slot 0, below are the state machine words
+#define PIPE_SLOTS          2
+#define PIPE_SLOT_WORDS     ((MAILBOX_SIZE - PIPE_MBX_OFFSET) / PIPE_SLOTS)
+#define PIPE_MAX_PAYLOAD    (PIPE_SLOT_WORDS - 1 - 4)   //!< payload words of OTA_CMD_DATA and chunks, a burst write always fits
+
+#define PIPE_READY          0x52U           //!< 'R': request written, owned by the firmware
+#define PIPE_BUSY           0x42U           //!< 'B': executing
+#define PIPE_DONE           0x44U           //!< 'D': reply written, owned by the reader
+#define PIPE_ERR_CMD        0xFFU           //!< status of a request which is neither burst, OTA nor chunk
+
+#define PIPE_HEADER(state_, status_, seq_) \
+    (((uint32_t) (state_) << 24) | ((uint32_t) ((status_) & 0xFFU) << 8) | ((uint32_t) (seq_) & 0xFFU))
+
+/**
+ * @brief Counters exported as data point
+ */
+typedef struct
+{
+    uint32_t executed;          //!< requests executed
+    uint16_t overlapped;        //!< requests made ready while another one was executing
+    uint16_t resyncs;           //!< expected sequence number missing, continued with the oldest ready slot
+} pipe_stats_t;
+
+extern pipe_stats_t pipe_stats;
+
+
+/**
+ * @brief  DAND app function, pends the execution of the ready slots.
+ * @param  mbx DAND mailbox
+ * @return number of slots owned by the firmware
+ */
+extern uint32_t pipe_handler(Mailbox_t* mbx);
+
+/**
+ * @brief Execute the ready slots, called by the bottom half.
+ */
+extern void pipe_run(void);
+
+/**
+ * @brief  A slot is owned by the firmware, the direct burst, OTA and chunk app functions are rejected meanwhile.
+ * @return true if a slot is in PIPE_READY or PIPE_BUSY
+ */
+extern bool pipe_busy(void);
+
+
+/** @} */ /* End of group mbx_pipe */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _MBX_PIPE_H_ */
@@ -0,0 +1,125 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     ndef_tag.h
+ *
+ * @brief    RAM backed NFC Forum Type 2 Tag with a status text record.
+ *
+ * @version  v1.0
+ * @date     2022-09-28
+ *
+ * @note     APARAM "tag_type_2_ptr" points to ::ndef_tag, so a phone gets lock state, last event,
+ *           challenge nonce and firmware version with a single native NDEF read.
+ *           The tag is a single NDEF text record of fixed length, e.g.
+ *           "Lock:L Event:01 Nonce:1A2B3C4D FW:V2.0.0000". The template including the firmware version
+ *           is built at compile time from version.h, the dynamic fields are patched in place.
+ *           The blocks behind the NDEF area are not announced in the capability container, but can be
+ *           read with T2T READ commands and serve as a 16 byte per frame transfer window.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _NDEF_TAG_H_
+#define _NDEF_TAG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup ndef_tag
+ * @{
+ */
+
+#define NDEF_TAG_EXT_WORDS      20      //!< size of the extension area in words
+
+/**
+ * @brief Events reported in the tag
+ */
+typedef enum
+{
+    ndef_event_none = 0x00,         //!< nothing happened since power up
+    ndef_event_auth_ok = 0x01,      //!< passcode accepted
+    ndef_event_auth_failed = 0x02,  //!< passcode rejected
+    ndef_event_registered = 0x03,   //!< new passcode issued on register request
+    ndef_event_field_weak = 0x04,   //!< actuation postponed, field too weak
+    ndef_event_actuated = 0x05      //!< lock moved to the new position
+} ndef_event_t;
+
+/**
+ * @brief Memory image of the tag as read by T2T READ commands (4 byte blocks)
+ */
+typedef struct
+{
+    uint8_t header[12];             //!< blocks 0..2: UID, internal and lock bytes
+    uint8_t cc[4];                  //!< block 3: capability container
+    uint8_t tlv[2];                 //!< NDEF message TLV: type, length
+    uint8_t record[4];              //!< record header: flags, type length, payload length, type 'T'
+    uint8_t lang[3];                //!< text record status byte and language code
+    char    lock_label[5];
+    char    lock;                   //!< 'L' locked, 'U' unlocked, 'l' locking, 'u' unlocking
+    char    event_label[7];
+    char    event[2];               //!< ndef_event_t as hex
+    char    nonce_label[7];
+    char    nonce[8];               //!< challenge nonce as hex
+    char    fw[13];                 //!< firmware version from version.h
+    uint8_t terminator;             //!< terminator TLV
+    uint8_t rfu[3];                 //!< pads the image to full blocks
+    uint32_t ext[NDEF_TAG_EXT_WORDS];   //!< blocks behind the NDEF area, e.g. the burst window (see burst.h)
+} ndef_tag_t;
+
+#define NDEF_TAG_EXT_BLOCK      (offsetof(ndef_tag_t, ext) / 4)     //!< T2T block number of ndef_tag_t::ext
+
+extern ndef_tag_t ndef_tag;
+
+
+/**
+ * @brief Copy the template into RAM, set the lock state from NVM and draw the first nonce.
+ */
+extern void ndef_tag_init(void);
+
+/**
+ * @brief Update the lock field.
+ * @param lock_phase Lock_State_enum_t
+ */
+extern void ndef_tag_set_lock(uint8_t lock_phase);
+
+/**
+ * @brief Update the event field.
+ * @param event last event
+ */
+extern void ndef_tag_set_event(ndef_event_t event);
+
+/**
+ * @brief  Draw a new challenge nonce and publish it in the tag.
+ * @return the new nonce
+ */
+extern uint32_t ndef_tag_new_nonce(void);
+
+
+/** @} */ /* End of group ndef_tag */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _NDEF_TAG_H_ */
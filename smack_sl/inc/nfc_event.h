@@ -0,0 +1,97 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     nfc_event.h
+ *
+ * @brief    Application events of the NFC interface, handed from the NFC interrupt to the main loop.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     NFC frames are received and answered in the contactless UART interrupt (IRQ 0): the ROM
+ *           handler runs nfc_state_machine() on every frame, enabled by nfc_init(). The DAND app
+ *           functions (APARAM app_prog[]) are called from there. The main loop does not touch the
+ *           frames, it only takes the completed requests from the event queue (ring.h) with
+ *           nfc_event_get(), so a busy main loop never delays a reply. During a motor pulse the NVM
+ *           is off and the interrupts are disabled, a pending frame switches the NVM on for its reply.
+ *           The other way, the state machine answers the reader in mailbox words 1 and 3...6 and the
+ *           status data point reads current_state and charge_progress. These are single aligned words
+ *           or bytes, written by one context at a time and polled by the reader, so they need no queue.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _NFC_EVENT_H_
+#define _NFC_EVENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ring.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup nfc_event
+ * @{
+ */
+
+#define NFC_EVENT_SIZE      8           //!< events queued, power of 2
+
+/**
+ * @brief Events, the argument depends on the event
+ */
+typedef enum
+{
+    nfc_event_exchange = 1,             //!< data exchange request executed, arg: 0
+    nfc_event_ota = 2,                  //!< OTA request executed, arg: command << 8 | ota_status_t
+    nfc_event_auth = 3,                 //!< passcode received, arg: 0 (auth_handler())
+    nfc_event_register = 4              //!< registration requested, arg: 0
+} nfc_event_t;
+
+
+/**
+ * @brief Queue an event, only called from the NFC interrupt.
+ * @param event nfc_event_t
+ * @param arg   argument of the event
+ */
+extern void nfc_event_post(nfc_event_t event, uint16_t arg);
+
+/**
+ * @brief  Take the oldest event, only called from the main loop.
+ * @param  e event and argument
+ * @return false if no event is queued
+ */
+extern bool nfc_event_get(ring_event_t* e);
+
+/**
+ * @brief  Events dropped because the main loop did not take them in time.
+ * @return number of dropped events
+ */
+extern uint16_t nfc_event_lost(void);
+
+
+/** @} */ /* End of group nfc_event */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _NFC_EVENT_H_ */
@@ -0,0 +1,91 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     nvm_persist.h
+ *
+ * @brief    Layout of and access to the NVM page holding persistent application data.
+ *
+ * @version  v1.0
+ * @date     2022-09-21
+ *
+ * @note     All persistent items share one NVM page. An update opens the assembly buffer (which copies
+ *           the current page content), lets every user stage its words and then erases and programs the
+ *           page once. This way several items are updated with a single erase cycle.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _NVM_PERSIST_H_
+#define _NVM_PERSIST_H_
+
+#include <stdint.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup nvm_persist
+ * @{
+ */
+
+/*
+   Previous firmware stored version data in the last flash page (0x1EFF4–0x1EFFF).
+   To avoid conflicts, persistent data is stored in the previous page.
+   With a page size of 128 bytes, the page spans 0x0001EF00–0x0001EF7F
+   (see section_persitent_NVM in Linker_config.ld).
+*/
+#define NVM_PERSIST_PAGE        0x0001EF00              //!< first address of the persistent page
+#define NVM_PERSIST_PAGE_SIZE   (N_BLOCKS * 8)          //!< page size in bytes
+
+#define LOCK_STATE_ADDR         0x0001EF10              //!< lock state word, followed by the passcode word
+#define VCLAMP_TABLE_ADDR       0x0001EF18              //!< vclamp tuning table (see vclamp_tuner.h)
+#define IMAGE_CRC_CACHE_ADDR    0x0001EF38              //!< image CRC verified last (see image_check.h)
+#define PERF_LIFETIME_ADDR      0x0001EF40              //!< lifetime counter totals (see perf.h), 32 bytes
+
+
+/**
+ * @brief  Power up the NVM and open the assembly buffer on the persistent page.
+ *         After this call, words of the page are modified by plain writes to their NVM address.
+ * @return 0 on success, error code of nvm_open_assembly_buffer() otherwise
+ */
+extern uint8_t nvm_persist_open(void);
+
+/**
+ * @brief  Erase the persistent page, program it with the content of the assembly buffer and
+ *         return the NVM to read mode.
+ * @return 0 on success, error code of nvm_program_page() otherwise
+ */
+extern uint8_t nvm_persist_commit(void);
+
+/**
+ * @brief  Erase and program the page of the open assembly buffer, counted in the performance
+ *         counters (perf.h). Does not return the NVM to read mode.
+ * @return 0 on success, error code of nvm_program_page() otherwise
+ */
+extern uint8_t nvm_write_page(void);
+
+
+/** @} */ /* End of group nvm_persist */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _NVM_PERSIST_H_ */
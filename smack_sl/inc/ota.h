@@ -0,0 +1,179 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     ota.h
+ *
+ * @brief    Firmware update over NFC with page level delta patches.
+ *
+ * @version  v1.0
+ * @date     2022-10-04
+ *
+ * @note     scripts/ota_patch.py compares the old and the new image_nvm.hex and emits the changed pages
+ *           as a sequence of mailbox requests. The requests are written to the mailbox starting at word
+ *           ::OTA_MBX_OFFSET and executed by calling app function ::OTA_APP_FUNCTION:
+ *
+ *           request          | +1         | +2                    | +3                  | +4 ...
+ *           -----------------|------------|-----------------------|---------------------|-------
+ *           OTA_CMD_BEGIN    | image CRC  | number of pages       | -                   | -
+ *           OTA_CMD_PAGE     | slot       | destination address   | CRC of the new page | -
+ *           OTA_CMD_DATA     | slot       | last << 16 | words    | CRC of the payload  | payload
+ *           OTA_CMD_COMMIT   | -          | -                     | -                   | -
+ *           OTA_CMD_ACTIVATE | -          | -                     | -                   | -
+ *
+ *           The payload of OTA_CMD_DATA holds runs of changed words relative to the old page content:
+ *           a header word (::OTA_RUN_FILL, word offset << 8, word count) followed by the words of the run
+ *           or, for a fill run, by a single word.
+ *
+ *           New pages are not written in place but into staging slots behind the code area, so the running
+ *           firmware stays intact during the download. After a field loss, the reader simply starts again:
+ *           OTA_CMD_PAGE answers ::ota_staged for slots which already hold the expected content, so
+ *           only missing pages are transferred again.
+ *           OTA_CMD_COMMIT calculates the CRC of the resulting image (range OTA_IMAGE_START to
+ *           OTA_STAGE_BASE without the device data, staged pages replacing the current ones) and only
+ *           on a match writes the directory page, which marks the update for activation. Activation
+ *           copies the slots to their destination from RAM with interrupts disabled and resets the
+ *           device. It is started by OTA_CMD_ACTIVATE or, if the field got lost before, at the next
+ *           startup.
+ *           The device data (provision.h) is neither covered by the image CRC nor accepted as
+ *           destination of OTA_CMD_PAGE, only provisioning stages it (ota_stage_device_page()).
+ *           A field loss during the copy of a page which holds startup code cannot be recovered by the
+ *           firmware itself, the ROM message_nvm_* commands still allow reprogramming in this case.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _OTA_H_
+#define _OTA_H_
+
+#include <stdint.h>
+#include "dand_handler.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup ota
+ * @{
+ */
+
+#define OTA_APP_FUNCTION    2                   //!< index in APARAM app_prog[]
+#define OTA_MBX_OFFSET      32                  //!< first mailbox word used for requests
+#define OTA_MAX_PAYLOAD     (MAILBOX_SIZE - OTA_MBX_OFFSET - 4)    //!< payload words per OTA_CMD_DATA
+
+#define OTA_PAGE_SIZE       128                 //!< NVM page size in bytes
+#define OTA_PAGE_WORDS      (OTA_PAGE_SIZE / 4)
+
+#define OTA_IMAGE_START     0x00010400UL        //!< first byte covered by the image CRC (APARAM)
+#define OTA_STAGE_BASE      0x0001D180UL        //!< directory page, followed by the staging slots
+#define OTA_DEVICE_START    0x00010600UL        //!< device data (APARAM secret[] and public[]), not covered by the CRC
+#define OTA_DEVICE_END      0x00010800UL
+#define OTA_STAGE_SLOTS     58                  //!< number of pages an update may change
+#define OTA_VERSION_PAGE    0x0001EF80UL        //!< version page, may be patched but is not covered by the CRC
+
+#define OTA_CMD_BEGIN       0x4F540001UL
+#define OTA_CMD_PAGE        0x4F540002UL
+#define OTA_CMD_DATA        0x4F540003UL
+#define OTA_CMD_COMMIT      0x4F540004UL
+#define OTA_CMD_ACTIVATE    0x4F540005UL
+
+#define OTA_RUN_FILL        0x80000000UL        //!< run header flag: repeat a single word
+#define OTA_DIR_MAGIC       0x4F544131UL        //!< 'OTA1': directory is valid, activation pending
+
+/**
+ * @brief Result of a request
+ */
+typedef enum
+{
+    ota_ok = 0,             //!< request executed
+    ota_staged = 1,         //!< slot already holds the expected page, no data needed
+    ota_err_cmd = 2,        //!< unknown command
+    ota_err_state = 3,      //!< request out of sequence
+    ota_err_range = 4,      //!< slot, address or run outside the allowed range
+    ota_err_crc = 5,        //!< payload or page CRC mismatch
+    ota_err_nvm = 6,        //!< programming failed
+    ota_err_image = 7,      //!< image CRC mismatch, update not committed
+    ota_err_busy = 8        //!< direct request while the mailbox pipe owns a slot (mbx_pipe.h)
+} ota_status_t;
+
+/**
+ * @brief Directory page: marks a committed update and lists the destinations of the slots
+ */
+typedef struct
+{
+    uint32_t magic;                         //!< OTA_DIR_MAGIC if an activation is pending
+    uint32_t image_crc;                     //!< CRC of the committed image
+    uint16_t count;                         //!< number of used slots
+    uint16_t rfu;
+    uint16_t dest_page[OTA_STAGE_SLOTS];    //!< destination address / OTA_PAGE_SIZE, per slot
+} ota_directory_t;
+
+
+/**
+ * @brief  DAND app function, executes the request in the mailbox.
+ * @param  mbx DAND mailbox
+ * @return ota_status_t
+ */
+extern uint32_t ota_handler(Mailbox_t* mbx);
+
+/**
+ * @brief  Execute a request at another location, e.g. a mailbox pipe slot (mbx_pipe.h).
+ * @param  req request as at mailbox word OTA_MBX_OFFSET, req[0] is replaced by the status
+ * @return ota_status_t
+ */
+extern ota_status_t ota_execute(uint32_t* req);
+
+/**
+ * @brief  Start staging pages, as OTA_CMD_BEGIN. Also used by other writers of the image (provision.h).
+ * @param  image_crc CRC of the image after activation
+ * @param  count     number of slots to be staged
+ * @return ota_status_t
+ */
+extern ota_status_t ota_stage_begin(uint32_t image_crc, uint32_t count);
+
+/**
+ * @brief  Stage a complete page of the device data (provision.h), which OTA_CMD_PAGE rejects.
+ * @param  slot    staging slot, below the count given to ota_stage_begin()
+ * @param  address destination address of the page, OTA_DEVICE_START...OTA_DEVICE_END
+ * @param  data    OTA_PAGE_WORDS words of new page content
+ * @return ota_ok, ota_staged if the slot already held the page, error otherwise
+ */
+extern ota_status_t ota_stage_device_page(uint8_t slot, uint32_t address, const uint32_t* data);
+
+/**
+ * @brief  Check the image CRC and mark the staged pages for activation, as OTA_CMD_COMMIT.
+ *         ota_resume() activates them.
+ * @return ota_status_t
+ */
+extern ota_status_t ota_stage_commit(void);
+
+/**
+ * @brief Finish an activation which was interrupted by a field loss. To be called first at startup,
+ *        does not return if an activation is pending.
+ */
+extern void ota_resume(void);
+
+
+/** @} */ /* End of group ota */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _OTA_H_ */
@@ -0,0 +1,126 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     perf.h
+ *
+ * @brief    Firmware performance counters of the session and of the device lifetime.
+ *
+ * @version  v1.0
+ * @date     2022-10-18
+ *
+ * @note     The counters are incremented where the events occur and exported together as data point
+ *           0x009B, so the app gets them with a single exchange.
+ *           The lifetime totals live in the persistent page (PERF_LIFETIME_ADDR). perf_stage() folds
+ *           the counters of the current session into the assembly buffer whenever the page is
+ *           written anyway (lock toggle, passcode, image check), so they never cost an erase cycle of
+ *           their own. The value staged is the total read at startup plus the session counters, so
+ *           folding several times per session does not count twice. Events after the last write of a
+ *           session are not part of the lifetime totals.
+ *           NFC frames are received and answered by the ROM interrupt handler, the firmware only
+ *           sees the requests passed to the app functions in APARAM.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _PERF_H_
+#define _PERF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup perf
+ * @{
+ */
+
+/**
+ * @brief Counters of the current session
+ */
+typedef struct
+{
+    uint32_t requests;              //!< NFC requests to the app functions (data exchange, burst, update)
+    uint32_t request_errors;        //!< burst and update requests answered with an error
+    uint32_t crc_errors;            //!< of those, CRC mismatches of the transferred data
+    uint32_t auth_ok;               //!< passcodes accepted
+    uint32_t auth_failures;         //!< passcodes rejected
+    uint32_t nvm_erases;            //!< NVM page erases
+    uint32_t nvm_erase_ticks;       //!< time spent erasing, in time base ticks
+    uint32_t nvm_programs;          //!< NVM page programs
+    uint32_t nvm_program_ticks;     //!< time spent programming, in time base ticks
+    uint32_t motor_pulses;          //!< motor pulses driven
+    uint32_t threshold_checks;      //!< supply threshold comparisons before the motor pulses
+    uint32_t threshold_wait_ticks;  //!< time the motor waited for the supply threshold
+    uint32_t harvest_checks;        //!< supply threshold comparisons of the main loop while harvesting
+} perf_session_t;
+
+/**
+ * @brief Totals over the device lifetime, stored in NVM
+ */
+typedef struct
+{
+    uint32_t sessions;              //!< startups
+    uint32_t requests;
+    uint32_t request_errors;
+    uint32_t auth_ok;
+    uint32_t auth_failures;
+    uint32_t nvm_erases;
+    uint32_t motor_pulses;
+    uint32_t rfu;
+} perf_lifetime_t;
+
+/**
+ * @brief Counters exported as data point
+ */
+typedef struct
+{
+    perf_session_t  session;
+    perf_lifetime_t lifetime;       //!< totals including the current session
+} perf_counters_t;
+
+extern perf_counters_t perf_counters;
+
+
+/**
+ * @brief Read the lifetime totals stored in NVM. To be called during startup.
+ */
+extern void perf_init(void);
+
+/**
+ * @brief Write the lifetime totals into the open assembly buffer of the persistent page.
+ */
+extern void perf_stage(void);
+
+/**
+ * @brief notify_tx callback of the counters data point, updates the lifetime totals.
+ * @param data_point_id id of the data point being read
+ */
+extern void perf_notify_tx(uint16_t data_point_id);
+
+
+/** @} */ /* End of group perf */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _PERF_H_ */
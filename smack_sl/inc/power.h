@@ -0,0 +1,110 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     power.h
+ *
+ * @brief    Reference counted power domains with on-time accounting.
+ *
+ * @version  v1.0
+ * @date     2022-10-13
+ *
+ * @note     Each user of a block calls power_acquire() before and power_release() after using it.
+ *           The block is switched on with the first user and switched off with the last one:
+ *
+ *           domain       | on                              | off
+ *           -------------|---------------------------------|---------------------------------------
+ *           SHC / sense  | shc_init()                      | shc_close()
+ *           UART         | by the user, set_uart_control() | set_uart_control(false, false, false)
+ *
+ *           Other blocks have no domain: the NVM is only switched off by the RAM code of
+ *           motor_pulse() (motor_stats_t), the time base needs the system timers all the time and the
+ *           ROM / NVM lib API has no clock gate for the AES unit.
+ *           The on-time of the domains is exported as data point. It is also updated by
+ *           power_notify_tx() in the NFC handler, so the accounting runs with interrupts masked.
+ *           The on and off functions do not, the users of a domain call power_acquire() and
+ *           power_release() from one context (SHC and provisioning UART: main loop, log UART:
+ *           with interrupts masked by log.c).
+ */
+
+/*lint -save -e960 */
+
+#ifndef _POWER_H_
+#define _POWER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup power
+ * @{
+ */
+
+/**
+ * @brief Power domains
+ */
+typedef enum
+{
+    power_domain_shc = 0,       //!< SHC and sense unit, they share the analog routing
+    power_domain_uart = 1,
+    power_domain_count
+} power_domain_t;
+
+/**
+ * @brief Statistics exported as data point
+ */
+typedef struct
+{
+    uint32_t on_ticks[power_domain_count];  //!< time each domain was on since startup, in time base ticks
+    uint8_t  users[power_domain_count];     //!< current number of users
+    uint8_t  rfu[2];
+} power_stats_t;
+
+extern power_stats_t power_stats;
+
+
+/**
+ * @brief Register a user of a domain, switches the domain on for the first user.
+ * @param domain power domain
+ */
+extern void power_acquire(power_domain_t domain);
+
+/**
+ * @brief Unregister a user of a domain, switches the domain off after the last user.
+ * @param domain power domain
+ */
+extern void power_release(power_domain_t domain);
+
+/**
+ * @brief notify_tx callback of the statistics data point, adds the current on period.
+ * @param data_point_id id of the data point being read
+ */
+extern void power_notify_tx(uint16_t data_point_id);
+
+
+/** @} */ /* End of group power */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _POWER_H_ */
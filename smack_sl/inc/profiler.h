@@ -0,0 +1,123 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     profiler.h
+ *
+ * @brief    Statistical profiler sampling the interrupted PC on the SysTick.
+ *
+ * @version  v1.0
+ * @date     2022-10-14
+ *
+ * @note     The M0 has no DWT, so the profiler counts where the SysTick interrupt hits. The NVM code
+ *           range is divided into buckets of 2^PROFILER_BUCKET_SHIFT bytes with one 16 bit counter
+ *           each, counters stop at 0xFFFF. Hits in ROM and in RAM code are counted in the entries behind
+ *           the buckets, followed by the rejected samples. The exception frame is searched behind the
+ *           EXC_RETURN the ROM dispatcher saved, a sample is rejected if none is found or the PC in the
+ *           frame points outside the code.
+ *           The reader writes the sampling period in core clock ticks to data point 0x0098, which
+ *           clears the histogram and starts sampling, 0 stops it. Data point 0x0097 returns the
+ *           profiler_info_t, the histogram is then fetched with burst reads (burst.h) from
+ *           profiler_info_t.histogram. scripts/profiler_symbolize.py maps the buckets to functions
+ *           with the map file of the build.
+ *           Code running with interrupts disabled (e.g. motor_pulse()) is not sampled, samples
+ *           pending meanwhile are attributed to the first instruction after it.
+ *           The profiler is only built in with PROFILER defined, it takes the SysTick handler in
+ *           APARAM and approx. 0.4 kByte RAM.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup profiler
+ * @{
+ */
+
+#define PROFILER_START          0x00010800UL    //!< first byte of NVM code covered by buckets
+#define PROFILER_END            0x0001D180UL    //!< end of NVM code, start of the OTA staging area
+#ifndef PROFILER_BUCKET_SHIFT
+#define PROFILER_BUCKET_SHIFT   8               //!< bucket size 256 bytes, 7 doubles resolution and RAM
+#endif
+#define PROFILER_BUCKETS        (((PROFILER_END - PROFILER_START) + (1UL << PROFILER_BUCKET_SHIFT) - 1) >> PROFILER_BUCKET_SHIFT)
+#define PROFILER_MIN_PERIOD     0x00000400UL    //!< shorter periods leave little time to the main loop
+#define PROFILER_MAX_PERIOD     0x01000000UL    //!< SysTick reload is 24 bit
+
+/**
+ * @brief Counters behind the buckets
+ */
+typedef enum
+{
+    profiler_bin_rom = 0,       //!< PC in ROM
+    profiler_bin_ram = 1,       //!< PC in RAM code (RAMFUNC)
+    profiler_bin_rejected = 2,  //!< no exception frame found, or its PC is not in NVM, ROM or RAM code
+    profiler_bin_count
+} profiler_bin_t;
+
+/**
+ * @brief Description of the histogram, exported as data point
+ */
+typedef struct
+{
+    uint32_t histogram;         //!< address of the uint16_t counters for burst reads
+    uint32_t start;             //!< address covered by the first bucket
+    uint32_t samples;           //!< samples taken since the start
+    uint32_t period;            //!< sampling period in core clock ticks, 0 if stopped
+    uint16_t buckets;           //!< number of buckets, followed by profiler_bin_count counters
+    uint8_t  shift;             //!< bucket size is 2^shift bytes
+    uint8_t  rfu;
+} profiler_info_t;
+
+extern profiler_info_t profiler_info;
+extern uint32_t profiler_period;
+
+
+/**
+ * @brief APARAM SysTick handler, called by the ROM interrupt dispatcher.
+ */
+extern void profiler_systick_handler(void);
+
+/**
+ * @brief Clear the histogram and start sampling.
+ * @param period sampling period in core clock ticks, 0 stops sampling
+ */
+extern void profiler_start(uint32_t period);
+
+/**
+ * @brief notify_rx callback of the period data point, starts or stops sampling.
+ * @param data_point_id id of the data point written
+ */
+extern void profiler_notify_rx(uint16_t data_point_id);
+
+
+/** @} */ /* End of group profiler */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _PROFILER_H_ */
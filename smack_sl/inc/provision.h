@@ -0,0 +1,181 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     provision.h
+ *
+ * @brief    Device data in APARAM and its provisioning over the UART on the production line.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     The device data (keys, serial number, application data) is the bundle of the APARAM
+ *           regions secret[] (provision_secret_t) and public[] (provision_public_t), PROVISION_PAGES
+ *           NVM pages. It is not part of the image CRC and not written by updates (ota.h).
+ *           With UART_PROVISION defined, the firmware receives the bundle over the UART if APARAM
+ *           disable_default_uart holds DISABLE_DEFAULT_UART, so the ROM leaves the UART to the
+ *           firmware, at the baudrate in APARAM default_uart_baudrate. Frames in both directions:
+ *
+ *           PROVISION_SOF | command | length | payload (length bytes) | CRC-32 of command to payload
+ *
+ *           command             | payload request                 | payload reply
+ *           --------------------|---------------------------------|-----------------------------------
+ *           PROVISION_CMD_INFO  | -                               | status, 3 bytes 0, provision_info_t
+ *           PROVISION_CMD_PAGE  | index, 3 bytes 0, page content  | status, ota_status_t
+ *           PROVISION_CMD_COMMIT| CRC-32 of all pages             | status, ota_status_t
+ *
+ *           The UART handler only queues the received bytes (ring.h), the frames are executed in the
+ *           main loop by provision_poll(). The host waits for the reply of a frame before sending the
+ *           next one. Pages are sent in
+ *           order from index 0, a rejected page is sent again. They are staged in the OTA slots, so
+ *           the commit verifies the bundle CRC and the image CRC and then writes all pages in a single
+ *           transaction, which is finished at the next startup after a power loss. The device resets
+ *           after the reply to the commit. A provisioned device rejects further bundles and switches
+ *           the UART off after the reply to PROVISION_CMD_INFO, which reads back the serial number.
+ *           scripts/provision.py drives several stations in parallel.
+ *           APARAM nvm_prot_sect holds 2 bits per NVM page (PROVISION_PROT_*), byte page / 4 from
+ *           NVM_BASE, bits 2 * (page % 4). sl_aparam.c sets the pages of secret[], the OTA staging
+ *           slots (provisioning leaves copies of secret[] there) and the persistent page with the
+ *           passcode (nvm_persist.h) to PROVISION_PROT_READ. The ROM checks the entries for reads of
+ *           the reader, the firmware itself is not restricted; burst.h honours them as well.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _PROVISION_H_
+#define _PROVISION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup provision
+ * @{
+ */
+
+#if defined(UART_PROVISION) && defined(UART_LOG)
+#error "UART_PROVISION and UART_LOG both need the UART"
+#endif
+
+#define PROVISION_START         0x00010600UL    //!< APARAM secret[], followed by public[]
+#define PROVISION_PAGES         4               //!< NVM pages of the bundle
+#define PROVISION_BAUDRATE      1000000UL       //!< fastest common rate, 28 MHz / 16 / 1.75
+#define PROVISION_UART_IRQ      9               //!< HP matrix IRQ the UART is routed to (9...14)
+
+#define PROVISION_PROT_OPEN     0x3U            //!< nvm_prot_sect entry: read and write allowed (erased)
+#define PROVISION_PROT_WRITE    0x2U            //!< write protected
+#define PROVISION_PROT_READ     0x1U            //!< read protected
+#define PROVISION_PROT_ALL      0x0U            //!< read and write protected
+
+#define PROVISION_SOF           0xA7            //!< first byte of a frame
+#define PROVISION_CMD_INFO      0x01
+#define PROVISION_CMD_PAGE      0x02
+#define PROVISION_CMD_COMMIT    0x03
+
+/**
+ * @brief Secret device data, APARAM secret[]
+ */
+typedef struct
+{
+    uint32_t passcode;          //!< passcode accepted until the first one is generated
+    uint8_t  key[16];           //!< AES-128 key of the device
+    uint8_t  app[236];          //!< further secret application data
+} provision_secret_t;
+
+/**
+ * @brief Public device data, APARAM public[]
+ */
+typedef struct
+{
+    uint32_t serial;            //!< serial number, 0xFFFFFFFF if not provisioned
+    uint8_t  app[252];          //!< further public application data
+} provision_public_t;
+
+#define PROVISION_SECRET        ((const provision_secret_t*) PROVISION_START)
+#define PROVISION_PUBLIC        ((const provision_public_t*) (PROVISION_START + sizeof(provision_secret_t)))
+
+/**
+ * @brief Result of a request
+ */
+typedef enum
+{
+    provision_ok = 0,           //!< request executed
+    provision_err_length = 1,   //!< payload length wrong for the command
+    provision_err_crc = 2,      //!< frame CRC mismatch
+    provision_err_cmd = 3,      //!< unknown command
+    provision_err_order = 4,    //!< page out of order or commit before all pages
+    provision_err_locked = 5,   //!< device already provisioned
+    provision_err_bundle = 6,   //!< bundle CRC mismatch
+    provision_err_stage = 7     //!< staging or commit failed, see ota_status_t
+} provision_status_t;
+
+/**
+ * @brief Reply payload of PROVISION_CMD_INFO
+ */
+typedef struct
+{
+    uint32_t image_crc;         //!< version.crc of the running image
+    uint32_t serial;            //!< provisioned serial number, 0xFFFFFFFF if none
+    uint32_t baudrate;          //!< UART baudrate in use
+} provision_info_t;
+
+
+/**
+ * @brief  Serial number of the device.
+ * @return provisioned serial number, SERIAL_NUMBER (smack_sl.h) if not provisioned
+ */
+extern uint32_t provision_serial(void);
+
+/**
+ * @brief  Read protection of an NVM page in APARAM nvm_prot_sect.
+ * @param  address any address, outside the NVM nothing is protected
+ * @return true if the reader may not read the page holding address
+ */
+extern bool provision_read_protected(uint32_t address);
+
+#ifdef UART_PROVISION
+
+/**
+ * @brief Take over the UART if enabled in APARAM. To be called during startup.
+ */
+extern void provision_init(void);
+
+/**
+ * @brief Execute the frames received so far. Called by the main loop.
+ */
+extern void provision_poll(void);
+
+/**
+ * @brief UART handler in APARAM, passes the received bytes to provision_poll().
+ */
+extern void provision_uart_handler(void);
+
+#endif /* UART_PROVISION */
+
+
+/** @} */ /* End of group provision */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _PROVISION_H_ */
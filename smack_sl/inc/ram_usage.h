@@ -0,0 +1,107 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     ram_usage.h
+ *
+ * @brief    Stack high-water mark by painting the unused RAM.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     The reset handler fills the RAM between the end of the static data (__HeapLimit) and
+ *           the current stack pointer with RAM_USAGE_PATTERN before the C runtime is set up. The
+ *           stack grows down into this area, ram_usage_update() searches the lowest word which no
+ *           longer holds the pattern. The stack is shared with the ROM, which calls the firmware
+ *           and its handlers, so ROM usage is included.
+ *           The result is exported as data point 0x009C. scripts/ram_report.py lists the static RAM
+ *           per module from the map file ("make ram_report").
+ */
+
+/*lint -save -e960 */
+
+#ifndef _RAM_USAGE_H_
+#define _RAM_USAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cmsis_compiler.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup ram_usage
+ * @{
+ */
+
+#define RAM_USAGE_PATTERN   0xC5C5C5C5UL    //!< fill value of the unused RAM
+#define RAM_USAGE_MARGIN    16              //!< bytes below the stack pointer not painted at startup
+
+/**
+ * @brief Statistics exported as data point, addresses and sizes in bytes
+ */
+typedef struct
+{
+    uint32_t stack_top;     //!< initial stack pointer (__StackTop)
+    uint32_t static_end;    //!< end of the static data, the painted area starts here (__HeapLimit)
+    uint32_t high_water;    //!< lowest address used by the stack so far
+    uint16_t stack_used;    //!< stack_top - high_water
+    uint16_t stack_size;    //!< stack reserved by the linker script (__STACK_SIZE)
+    uint16_t headroom;      //!< high_water - static_end, RAM never touched
+    uint16_t rfu;
+} ram_usage_t;
+
+extern ram_usage_t ram_usage;
+
+
+/**
+ * @brief Paint the RAM below the stack pointer. To be called first by the reset handler.
+ */
+__STATIC_FORCEINLINE void ram_usage_paint(void)
+{
+    extern uint32_t __HeapLimit;
+    uint32_t* p = &__HeapLimit;
+    uint32_t* end = (uint32_t*) (__get_MSP() - RAM_USAGE_MARGIN);
+
+    while (p < end)
+    {
+        *p++ = RAM_USAGE_PATTERN;
+    }
+}
+
+/**
+ * @brief Search the high-water mark of the stack and update ram_usage.
+ */
+extern void ram_usage_update(void);
+
+/**
+ * @brief notify_tx callback of the statistics data point, calls ram_usage_update().
+ * @param data_point_id id of the data point being read
+ */
+extern void ram_usage_notify_tx(uint16_t data_point_id);
+
+
+/** @} */ /* End of group ram_usage */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _RAM_USAGE_H_ */
@@ -0,0 +1,153 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     ring.h
+ *
+ * @brief    Lock free single producer, single consumer rings and event queues.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     For the handoff between an interrupt handler and the main loop without disabling interrupts.
+ *           The Cortex-M0 has no LDREX/STREX, so every index has a single writer: the producer only
+ *           advances head, the consumer only advances tail. Both run freely over 16 bit, with a capacity
+ *           of a power of 2 (checked at compile time) head - tail is the fill level across the wrap.
+ *           An item is written or read before its index moves, with a barrier in between, so the other
+ *           side never sees a torn item. The consumer also has a barrier between reading head and
+ *           reading the item, matching the one of the producer. 16 bit stores are atomic.
+ *
+ *           A ring is declared with RING_T(type, capacity) and zero initialized (static storage), e.g.
+ *           static RING_T(uint8_t, 64) rx;  ...  if (!RING_PUSH(rx, value)) ...;  RING_POP(rx, &value)
+ *           The macros evaluate their ring argument several times, it has to be a plain variable.
+ *           An event queue is a ring of ring_event_t which also counts the events it had to drop.
+ *           Exactly one context may push and one context may pop, e.g. one handler and the main loop.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _RING_H_
+#define _RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cmsis_compiler.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup ring
+ * @{
+ */
+
+// capacity, fails to compile if it is not a power of 2 in 1...32768
+#define RING_CHECKED(capacity_) \
+    ((capacity_) + 0 * sizeof(char[(((capacity_) & ((capacity_) - 1)) == 0) && ((capacity_) <= 32768) ? 1 : -1]))
+
+/**
+ * @brief Ring type with capacity items of type, capacity a power of 2
+ */
+#define RING_T(type_, capacity_) \
+    struct { volatile uint16_t head; volatile uint16_t tail; type_ item[RING_CHECKED(capacity_)]; }
+
+#define RING_CAPACITY(r_)   ((uint16_t) (sizeof((r_).item) / sizeof((r_).item[0])))
+#define RING_COUNT(r_)      ((uint16_t) ((r_).head - (r_).tail))
+#define RING_EMPTY(r_)      ((r_).head == (r_).tail)
+#define RING_FULL(r_)       (RING_COUNT(r_) >= RING_CAPACITY(r_))
+
+/**
+ * @brief  Producer: append value.
+ * @return false if the ring is full, value is dropped
+ */
+#define RING_PUSH(r_, value_) \
+    (RING_FULL(r_) ? false : \
+     ((r_).item[(r_).head & (RING_CAPACITY(r_) - 1U)] = (value_), ring_advance(&(r_).head), true))
+
+/**
+ * @brief  Consumer: take the oldest item into *dst.
+ * @return false if the ring is empty
+ */
+#define RING_POP(r_, dst_) \
+    (RING_EMPTY(r_) ? false : \
+     (ring_acquire(), *(dst_) = (r_).item[(r_).tail & (RING_CAPACITY(r_) - 1U)], ring_advance(&(r_).tail), true))
+
+/**
+ * @brief Consumer: pointer to the oldest item, only valid if the ring is not empty, released by RING_DROP()
+ */
+#define RING_PEEK(r_)       (ring_acquire(), &(r_).item[(r_).tail & (RING_CAPACITY(r_) - 1U)])
+#define RING_DROP(r_)       ring_advance(&(r_).tail)
+
+/**
+ * @brief Consumer: discard all items
+ */
+#define RING_FLUSH(r_)      ((r_).tail = (r_).head)
+
+/**
+ * @brief Event of an event queue, fits a single store
+ */
+typedef struct
+{
+    uint16_t id;                //!< event, defined by the user of the queue
+    uint16_t arg;               //!< argument
+} ring_event_t;
+
+/**
+ * @brief Event queue type, a ring of ring_event_t with a counter of dropped events
+ */
+#define EVENT_QUEUE_T(capacity_) \
+    struct { volatile uint16_t head; volatile uint16_t tail; volatile uint16_t lost; \
+             ring_event_t item[RING_CHECKED(capacity_)]; }
+
+/**
+ * @brief  Producer: post an event, counts it in lost if the queue is full.
+ * @return false if the event was dropped
+ */
+#define EVENT_POST(q_, id_, arg_) \
+    (RING_PUSH(q_, ((ring_event_t) { (uint16_t) (id_), (uint16_t) (arg_) })) ? true : \
+     ((q_).lost = (uint16_t) ((q_).lost + 1U), false))
+
+/**
+ * @brief  Consumer: take the oldest event into *dst.
+ * @return false if the queue is empty
+ */
+#define EVENT_GET(q_, dst_)     RING_POP(q_, dst_)
+
+
+// publish an item access by moving the index, only called by the owner of the index
+__STATIC_FORCEINLINE void ring_advance(volatile uint16_t* index)
+{
+    __DMB();
+    *index = (uint16_t) (*index + 1U);
+}
+
+// the item is read only after head was seen beyond it, called by the consumer
+__STATIC_FORCEINLINE void ring_acquire(void)
+{
+    __DMB();
+}
+
+
+/** @} */ /* End of group ring */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _RING_H_ */
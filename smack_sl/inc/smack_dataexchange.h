@@ -19,7 +19,13 @@
  * @version  v1.0
  * @date     2022-09-21
  *
- * @note
+ * @note     The data exchange library calls notify_rx from the NFC handler, before the reply is sent.
+ *           Data points with data_exchange_defer_rx() as notify_rx only queue their id there, their real
+ *           notify_rx in deferred_rx_list[] runs afterwards in the bottom half: Event_Bus8 pended by
+ *           software at the lowest priority (the ROM PendSV handler cannot be redirected), dispatched by
+ *           the ROM to APARAM timer4_hand_addr. It preempts the main loop and may take its time.
+ *           notify_tx cannot be deferred, it prepares the value to be sent. The bottom half also executes
+ *           the requests of the mailbox pipe (mbx_pipe.h).
  */
 
 /* lint -save -e960 */
@@ -27,6 +33,9 @@
 #ifndef _SMACK_DATAEXCHANGE_H_
 #define _SMACK_DATAEXCHANGE_H_
 
+#include <stdint.h>
+#include "dand_handler.h"
+
 
 /** @addtogroup Infineon
  * @{
@@ -42,9 +51,66 @@
  */
 
 
+#define DATA_EXCHANGE_DEFER_SIZE    8       //!< deferred notifications queued, power of 2
+
+/**
+ * @brief Notification executed in the bottom half
+ */
+typedef struct
+{
+    uint16_t data_point_id;                 //!< data point written
+    void     (*notify_rx)(uint16_t);        //!< function called with data_point_id
+} deferred_rx_entry_t;
+
+
 // Prototypes
 
 extern void vars_init(void);
+extern void data_exchange_handler(void);
+
+/**
+ * @brief  App function of the encrypted data points (dp_crypt.h), in APARAM app_prog[DP_CRYPT_APP_FUNCTION].
+ * @param  mbx DAND mailbox
+ * @return dp_crypt_status_t
+ */
+extern uint32_t data_exchange_crypt_handler(Mailbox_t* mbx);
+
+/**
+ * @brief  App function of the chunked objects (dp_chunk.h), in APARAM app_prog[DP_CHUNK_APP_FUNCTION].
+ * @param  mbx DAND mailbox
+ * @return dp_chunk_status_t
+ */
+extern uint32_t data_exchange_chunk_handler(Mailbox_t* mbx);
+
+/**
+ * @brief  Execute a chunk request on the object list at another location, e.g. a mailbox pipe slot.
+ * @param  req        request as at mailbox word DP_CHUNK_MBX_OFFSET, replaced by the reply
+ * @param  max_length largest chunk fitting behind req
+ * @return dp_chunk_status_t
+ */
+extern uint32_t data_exchange_chunk_execute(uint32_t* req, uint32_t max_length);
+
+/**
+ * @brief notify_rx of deferred data points, queues the id and pends the bottom half.
+ * @param data_point_id data point written
+ */
+extern void data_exchange_defer_rx(uint16_t data_point_id);
+
+/**
+ * @brief  Deferred notifications dropped because the queue was full.
+ * @return number of dropped notifications
+ */
+extern uint16_t data_exchange_deferred_lost(void);
+
+/**
+ * @brief Pend the bottom half, e.g. from an NFC app function.
+ */
+extern void data_exchange_schedule(void);
+
+/**
+ * @brief Bottom half in APARAM (timer4_hand_addr), runs the queued notifications and pipe_run().
+ */
+extern void data_exchange_bottom_half(void);
 
 
 /** @} */ /* End of group fw_config */
@@ -46,11 +46,34 @@ extern void hardfault_handler(void);
 
 extern uint16_t get_threshold_from_voltage(float);
 
-extern const uint8_t smack_sl_tag[];
-
 // Offer a counter for external access
 extern uint32_t sl_counter;
 
+/** Execute a function from RAM (section .ramfunc, copied at startup, see Linker_config.ld).
+    Code running with the NVM switched off may only call other RAMFUNC and ROM functions, with interrupts
+    disabled: the ROM dispatches interrupts through the handler addresses in APARAM.
+    Define NO_RAMFUNC to keep everything in NVM, e.g. to compare timing and supply current. */
+#ifndef NO_RAMFUNC
+#define RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+/**
+ * @brief Motor statistics, exported as data point (ticks of the time base)
+ */
+typedef struct
+{
+    uint32_t nvm_off_ticks;     //!< NVM switched off during the last pulse
+    uint32_t nvm_off_total;     //!< NVM switched off during all pulses since startup
+    uint32_t compare_ticks;     //!< average duration of one comparator reading while waiting for the last pulse
+    uint16_t compares;          //!< comparator readings while waiting for the last pulse
+    uint16_t pulses;            //!< motor pulses since startup
+    uint32_t nfc_frames;        //!< NFC frames answered during the pulses since startup
+} motor_stats_t;
+
+extern motor_stats_t motor_stats;
+
 typedef enum 
 {
     POWER_POWER_OFF = 0, 
@@ -60,6 +83,8 @@ typedef enum
     POWER_IDLE = 4
 } Power_State_enum_t; 
 
+extern volatile Power_State_enum_t current_state;   //!< also read by the NFC interrupt (charge_progress.h)
+
 typedef enum 
 {
     LOCK_LOCKED = 0, 
@@ -77,8 +102,21 @@ typedef enum
 #define REGISTER_RQ       0xEFEFEFEF
 #define SERIAL_NUMBER     0xFEDCBA20
 #define REG_ERROR         0x88888888
+#define FIELD_WEAK        0x77777777
+
+#define AUTH_APP_FUNCTION 6            //!< index in APARAM app_prog[]
+
+/**
+ * @brief APARAM app function AUTH_APP_FUNCTION, the reader calls it after writing the passcode or REGISTER_RQ to
+ *        mailbox word 2. Posts nfc_event_auth or nfc_event_register, the state machine answers in word 3 or 4.
+ */
+extern void auth_handler(void);
+
+#define MOTOR_TIMER_LINE    14         //!< HP matrix line of the charge wait, IRQ_MAP_HP14
+#define MOTOR_TIMER_CHANNEL 0          //!< system timer of the charge wait, PM0_IRQ_HAND
 
 #define MAX_MOTOR_ROTATIONS 8
+#define MOTOR_THRESHOLD_VOLTAGE 3.0F   //!< storage capacitor voltage needed to drive the motor
 
 /** @} */ /* End of group fw_config */
 
@@ -0,0 +1,157 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     spi.h
+ *
+ * @brief    Interrupt driven SPI master transfers on the SSP.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     The ROM configures the SSP (config_spi(), control_spi()) but has no transfer function.
+ *           spi_start() starts a full duplex transfer and returns, the SSP interrupt (APARAM
+ *           ssp_hand_addr, matrix IRQ SPI_IRQ) moves the data through the 8 entry FIFOs and calls
+ *           the completion callback from interrupt context. At most SPI_FIFO_DEPTH bytes are in
+ *           flight, so the RX FIFO cannot overrun. spi_wait() sleeps until the transfer is done.
+ *           Chip select is left to the caller (GPIO).
+ *           The bit rate is 28 MHz / (SPI_PRESCALE * (1 + scr)), i.e. 14 MHz at most.
+ *           The driver is only built in with SPI_DRIVER defined, it takes the SSP handler in APARAM.
+ *           With SPI_BENCHMARK defined (implies SPI_DRIVER, see irq_map.h), spi_benchmark() measures
+ *           loopback transfers of SPI_BENCH_BYTES bytes at SPI_BENCH_RATES bit rates from 14 MHz down,
+ *           data point 0x009D returns the result.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _SPI_H_
+#define _SPI_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssp_drv.h"
+#include "irq_map.h"
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup spi
+ * @{
+ */
+
+#define SPI_IRQ             10          //!< HP matrix IRQ the SSP is routed to (9...14)
+#define SPI_FIFO_DEPTH      8           //!< entries of the TX and RX FIFO
+#define SPI_PRESCALE        2           //!< clock prescaler, even, 2...254
+#define SPI_FILL            0xFF        //!< sent when no TX data is given
+
+#define SPI_BENCH_BYTES     128         //!< bytes per benchmark transfer
+#define SPI_BENCH_RATES     6           //!< rates measured
+
+/**
+ * @brief Callback at the end of a transfer, runs in interrupt context
+ * @param length bytes transferred
+ */
+typedef void (*spi_callback_t)(uint16_t length);
+
+/**
+ * @brief Result of a benchmark transfer
+ */
+typedef struct
+{
+    uint32_t bitrate;           //!< configured bit rate in bit/s
+    uint32_t ticks;             //!< time of the transfer in core clock ticks
+    uint32_t busy_ticks;        //!< of those, time spent in the SSP handler
+    uint16_t irqs;              //!< SSP interrupts taken
+    uint16_t errors;            //!< bytes read back different from the bytes sent
+} spi_bench_entry_t;
+
+/**
+ * @brief Benchmark results exported as data point
+ */
+typedef struct
+{
+    spi_bench_entry_t rate[SPI_BENCH_RATES];
+} spi_bench_t;
+
+
+#ifdef SPI_DRIVER
+
+/**
+ * @brief Configure the SSP as SPI master with 8 bit frames and enable it.
+ * @param scr      serial clock rate, bit rate = 28 MHz / (SPI_PRESCALE * (1 + scr))
+ * @param polarity clock polarity
+ * @param phase    clock phase
+ * @param loop_back true connects TX to RX internally (test)
+ */
+extern void spi_init(uint8_t scr, ssp_polarity_t polarity, ssp_phase_t phase, bool loop_back);
+
+/**
+ * @brief Disable the SSP.
+ */
+extern void spi_close(void);
+
+/**
+ * @brief  Start a full duplex transfer.
+ * @param  tx     bytes to send, NULL sends SPI_FILL
+ * @param  rx     buffer for the received bytes, NULL discards them
+ * @param  length number of bytes
+ * @param  done   called when the transfer is complete, may be NULL
+ * @return false if a transfer is still running
+ */
+extern bool spi_start(const uint8_t* tx, uint8_t* rx, uint16_t length, spi_callback_t done);
+
+/**
+ * @brief  Check for a running transfer.
+ * @return true while a transfer is running
+ */
+extern bool spi_busy(void);
+
+/**
+ * @brief Wait for the end of the running transfer, the core sleeps meanwhile. The interrupts are enabled
+ *        while sleeping, the PRIMASK of the caller is restored on return.
+ */
+extern void spi_wait(void);
+
+/**
+ * @brief SSP handler in APARAM.
+ */
+extern void spi_ssp_handler(void);
+
+#ifdef SPI_BENCHMARK
+
+extern spi_bench_t spi_bench;
+
+/**
+ * @brief Measure loopback transfers at all rates of spi_bench_t, leaves the SSP disabled.
+ */
+extern void spi_benchmark(void);
+
+#endif /* SPI_BENCHMARK */
+
+#endif /* SPI_DRIVER */
+
+
+/** @} */ /* End of group spi */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _SPI_H_ */
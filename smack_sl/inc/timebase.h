@@ -0,0 +1,83 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     timebase.h
+ *
+ * @brief    Free running 32 bit time base for time distance measurements.
+ *
+ * @version  v1.0
+ * @date     2022-09-21
+ *
+ * @note     The time base runs on a cascaded system timer pair without interrupt. One tick equals one
+ *           core clock cycle, so the counter wraps after approx. 150s @28MHz. Time distances are calculated
+ *           with unsigned arithmetic and therefore survive a single wrap around.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _TIMEBASE_H_
+#define _TIMEBASE_H_
+
+#include <stdint.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup timebase
+ * @{
+ */
+
+#define TIMEBASE_CHANNEL        3                   //!< system timer channel (cascaded with channel 2)
+#define TIMEBASE_TICKS_PER_MS   (XTAL / 1000UL)     //!< ticks per millisecond @28MHz
+
+/**
+ * @brief Start the free running time base.
+ */
+extern void timebase_init(void);
+
+/**
+ * @brief  Read the current time stamp.
+ * @return current count of the time base in core clock ticks
+ */
+extern uint32_t timebase_now(void);
+
+/**
+ * @brief  Calculate the time passed since a time stamp.
+ * @param  start time stamp taken with timebase_now()
+ * @return elapsed time in core clock ticks
+ */
+extern uint32_t timebase_ticks_since(uint32_t start);
+
+/**
+ * @brief  Calculate the time passed since a time stamp.
+ * @param  start time stamp taken with timebase_now()
+ * @return elapsed time in milliseconds
+ */
+extern uint32_t timebase_ms_since(uint32_t start);
+
+
+/** @} */ /* End of group timebase */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _TIMEBASE_H_ */
@@ -0,0 +1,118 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     trace.h
+ *
+ * @brief    Time stamped event trace of the power state machine.
+ *
+ * @version  v1.0
+ * @date     2022-10-17
+ *
+ * @note     trace_event() writes time, event and argument into a ring of TRACE_SIZE records, older
+ *           records are overwritten. The time stamp is the time base (timebase.h) in core clock ticks.
+ *           The reader downloads the ring through two data points:
+ *           - 0x0099 (uint32, write): sequence number of the next record to read, 0 starts with the
+ *             oldest record still in the ring.
+ *           - 0x009A (array, read): trace_chunk_t with the records from the read position on, the
+ *             position advances with every read. Read until count is 0.
+ *           scripts/trace_to_chrome.py turns the chunks into a timeline for chrome://tracing.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup trace
+ * @{
+ */
+
+#define TRACE_SIZE      32      //!< records in the ring, power of 2
+#define TRACE_CHUNK     7       //!< records per data point read
+
+/**
+ * @brief Traced events
+ */
+typedef enum
+{
+    trace_boot = 0,             //!< main loop entered, arg: 0
+    trace_state = 1,            //!< power state machine entered a state, arg: Power_State_enum_t
+    trace_auth = 2,             //!< passcode checked, arg: 1 accepted, 0 rejected
+    trace_field = 3,            //!< field evaluated before actuation, arg: field_decision_t
+    trace_pulse_begin = 4,      //!< motor pulse started, arg: pulse number
+    trace_pulse_end = 5,        //!< motor pulse finished, arg: pulse number
+    trace_exchange = 6,         //!< data exchange set up on first use, arg: 0
+    trace_request = 7           //!< NFC request completed (nfc_event.h), arg: nfc_event_t
+} trace_event_t;
+
+/**
+ * @brief One record
+ */
+typedef struct
+{
+    uint32_t time;              //!< timebase_now() when the event occurred
+    uint16_t event;             //!< trace_event_t
+    uint16_t arg;               //!< event specific argument
+} trace_record_t;
+
+/**
+ * @brief Reply of the trace data point
+ */
+typedef struct
+{
+    uint32_t written;                       //!< records written since startup
+    uint32_t first;                         //!< sequence number of record[0]
+    uint8_t  count;                         //!< valid records in this chunk
+    uint8_t  rfu[3];
+    trace_record_t record[TRACE_CHUNK];
+} trace_chunk_t;
+
+extern trace_chunk_t trace_chunk;
+extern uint32_t trace_cursor;
+
+
+/**
+ * @brief Append a record to the ring, also from handlers.
+ * @param event event id
+ * @param arg   event specific argument
+ */
+extern void trace_event(trace_event_t event, uint16_t arg);
+
+/**
+ * @brief notify_tx callback of the trace data point, fills trace_chunk and advances the read position.
+ * @param data_point_id id of the data point being read
+ */
+extern void trace_notify_tx(uint16_t data_point_id);
+
+
+/** @} */ /* End of group trace */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _TRACE_H_ */
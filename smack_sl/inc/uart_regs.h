@@ -0,0 +1,68 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     uart_regs.h
+ *
+ * @brief    Registers of the UART, for the drivers which bypass the ROM UART functions.
+ *
+ * @version  v1.0
+ * @date     2022-10-19
+ *
+ * @note     The UART is an ARM PL011 in the HW2 peripheral range (dand_handler.h HW2_START). The
+ *           SDK headers do not define its registers, the base address is the one of the ROM driver
+ *           (uart_drv.h): set_uart_baudrate() and init_uart() write IBRD, FBRD, LCRH and CR at
+ *           0x20011024...0x20011030. The ROM driver only sends its own buffers and handles its own
+ *           protocol, log.h and provision.h access the FIFOs directly.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _UART_REGS_H_
+#define _UART_REGS_H_
+
+#include <stdint.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup uart_regs
+ * @{
+ */
+
+#define UART_BASE           0x20011000UL
+#define UART_DR             (*((volatile uint32_t*) (UART_BASE + 0x000)))   //!< data
+#define UART_FR             (*((volatile uint32_t*) (UART_BASE + 0x018)))   //!< flags
+#define UART_IMSC           (*((volatile uint32_t*) (UART_BASE + 0x038)))   //!< interrupt mask
+
+#define UART_FR_BUSY        (1UL << 3)      //!< transmitting
+#define UART_FR_RXFE        (1UL << 4)      //!< RX FIFO empty
+#define UART_FR_TXFF        (1UL << 5)      //!< TX FIFO full
+#define UART_IMSC_TXIM      (1UL << 5)      //!< TX interrupt enabled
+#define UART_IMSC_RTIM      (1UL << 6)      //!< RX timeout interrupt enabled
+
+
+/** @} */ /* End of group uart_regs */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _UART_REGS_H_ */
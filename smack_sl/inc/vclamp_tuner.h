@@ -0,0 +1,121 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/**
+ * @file     vclamp_tuner.h
+ *
+ * @brief    Adaptive vclamp selection to minimize the charge time of the storage capacitor.
+ *
+ * @version  v1.0
+ * @date     2022-09-21
+ *
+ * @note     The field strength (RSSI) at the start of harvesting selects a band. For each band, the
+ *           time to reach the motor threshold is recorded per vclamp setting. Settings without a
+ *           measurement are tried first, afterwards the fastest one is used. Measurements are
+ *           smoothed, so the ranking follows slow changes of the antenna setup.
+ *           The table is stored in the persistent NVM page together with the lock state.
+ */
+
+/*lint -save -e960 */
+
+#ifndef _VCLAMP_TUNER_H_
+#define _VCLAMP_TUNER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @addtogroup Infineon
+ * @{
+ */
+
+/** @addtogroup Smack_sl
+ * @{
+ */
+
+
+/** @addtogroup vclamp_tuner
+ * @{
+ */
+
+#define VCLAMP_TUNER_SETTINGS   3           //!< number of vclamp settings (see vclamp_set())
+#define VCLAMP_TUNER_BANDS      4           //!< number of field strength bands
+#define VCLAMP_TUNER_UNKNOWN    0xFFFF      //!< no measurement available (erased NVM)
+
+/**
+ * @brief Charge times of one field strength band, one entry per vclamp setting
+ */
+typedef struct
+{
+    uint16_t charge_ms[VCLAMP_TUNER_SETTINGS];  //!< smoothed time to threshold in ms
+    uint16_t rfu;                               //!< keeps the entry word aligned
+} vclamp_tuner_band_t;
+
+/**
+ * @brief Result of the latest harvesting cycle, exported as data point
+ */
+typedef struct
+{
+    uint16_t rssi;              //!< field strength at start of harvesting
+    uint8_t  band;              //!< field strength band derived from rssi
+    uint8_t  setting;           //!< vclamp setting used
+    uint8_t  default_setting;   //!< factory vclamp setting found at startup
+    uint8_t  explored;          //!< 1: setting was tried because it had no measurement yet
+    uint16_t charge_ms;         //!< measured time to threshold, VCLAMP_TUNER_UNKNOWN if not measured
+    uint16_t default_ms;        //!< smoothed time to threshold of the factory setting in this band
+    uint16_t best_ms;           //!< smoothed time to threshold of the best setting in this band
+} vclamp_tuner_stats_t;
+
+extern vclamp_tuner_stats_t vclamp_tuner_stats;
+
+
+/**
+ * @brief Load the tuning table from NVM and remember the factory vclamp setting.
+ */
+extern void vclamp_tuner_init(void);
+
+/**
+ * @brief Measure the field strength, select and apply the vclamp setting and start timing.
+ *        To be called when harvesting starts. No measurement is taken if the capacitor is
+ *        already charged.
+ */
+extern void vclamp_tuner_begin(void);
+
+/**
+ * @brief Stop timing and update the tuning table. To be called when the threshold is reached.
+ */
+extern void vclamp_tuner_end(void);
+
+/**
+ * @brief  Look up the expected charge time for a field strength.
+ * @param  rssi field strength as returned by get_nfc_value(nfc_sel_rssi)
+ * @return smoothed time to threshold of the best known setting in the matching band in ms,
+ *         VCLAMP_TUNER_UNKNOWN if the band has no measurement yet
+ */
+extern uint16_t vclamp_tuner_expected_ms(uint16_t rssi);
+
+/**
+ * @brief  Write a changed tuning table into the open assembly buffer of the persistent page.
+ *         Must be called between nvm_persist_open() and nvm_persist_commit().
+ * @return true if the table was written
+ */
+extern bool vclamp_tuner_stage(void);
+
+
+/** @} */ /* End of group vclamp_tuner */
+
+
+/** @} */ /* End of group Smack_sl */
+
+/** @} */ /* End of group Infineon */
+
+#endif /* _VCLAMP_TUNER_H_ */
@@ -0,0 +1,78 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     aes_key.c
+ *  @brief    Tracks the key loaded into the AES unit, so it is only loaded again after a change.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// Smack NVM lib
+#include "aes_lib.h"
+
+// smack_sl project
+#include "aes_key.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+aes_key_stats_t aes_key_stats;
+
+static const aes_block_t* volatile current;
+
+
+//-------------------------------------------------------------
+
+void aes_key_use(const aes_block_t* key)
+{
+    if (key == current)
+    {
+        aes_key_stats.skipped++;
+        return;
+    }
+
+    // invalid while the round keys are calculated
+    current = NULL;
+    aes_load_key_ba(key);
+    current = key;
+    aes_key_stats.loads++;
+}
+
+void aes_key_loaded(const aes_block_t* key)
+{
+    current = key;
+}
+
+void aes_key_invalidate(void)
+{
+    current = NULL;
+}
+
+void aes_key_random(uint32_t* random)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    // the generator is called from the main loop, an NFC handler must not load its key in between
+    __disable_irq();
+    current = NULL;
+    generate_random_number(random);
+    current = NULL;
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,63 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     boot.c
+ *  @brief    Startup profile and lazy initialization of subsystems not needed to answer NFC.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// smack_sl project
+#include "timebase.h"
+#include "boot.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+boot_profile_t boot_profile;
+
+static uint32_t boot_start;
+static uint32_t last_mark;
+
+
+//-------------------------------------------------------------
+
+void boot_profile_start(void)
+{
+    timebase_init();
+    boot_start = timebase_now();
+    last_mark = boot_start;
+}
+
+void boot_profile_mark(boot_step_t step)
+{
+    uint32_t now = timebase_now();
+
+    boot_profile.step_ticks[step] = now - last_mark;
+    last_mark = now;
+    boot_profile.ready = now - boot_start;
+}
+
+void boot_profile_record(boot_step_t step, uint32_t start)
+{
+    boot_profile.step_ticks[step] = timebase_ticks_since(start);
+}
+
+uint32_t boot_profile_uptime(void)
+{
+    return timebase_ticks_since(boot_start);
+}
@@ -0,0 +1,206 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     burst.c
+ *  @brief    Burst read/write of memory blocks as DAND app function.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "crc32.h"
+#include "perf.h"
+#include "ndef_tag.h"
+#include "nvm_persist.h"
+#include "ota.h"
+#include "provision.h"
+#include "burst.h"
+#include "mbx_pipe.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+static uint32_t next_read;
+static uint32_t next_write;
+
+
+//-------------------------------------------------------------
+
+static burst_window_t* get_window(void)
+{
+    return (burst_window_t*) ndef_tag.ext;
+}
+
+static bool is_ram(uint32_t address)
+{
+    return ((address >= RAM1_START) && (address < RAM1_STOP)) ||
+           ((address >= RAM2_START) && (address < RAM2_STOP));
+}
+
+static bool overlaps(uint32_t address, uint32_t length, uint32_t start, uint32_t end)
+{
+    return (address < end) && (start < (address + length));
+}
+
+// the key and passcode in APARAM secret[], the lock state and generated passcode in the persistent page
+static bool is_secret(uint32_t address, uint32_t length)
+{
+    return overlaps(address, length, PROVISION_START, PROVISION_START + sizeof(provision_secret_t)) ||
+           overlaps(address, length, NVM_PERSIST_PAGE, NVM_PERSIST_PAGE + NVM_PERSIST_PAGE_SIZE);
+}
+
+// pages set to read protection in APARAM nvm_prot_sect
+static bool is_read_protected(uint32_t address, uint32_t length)
+{
+    for (uint32_t page = address & ~(OTA_PAGE_SIZE - 1U); page < (address + length); page += OTA_PAGE_SIZE)
+    {
+        if (provision_read_protected(page))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// word accesses where possible, peripheral registers do not accept byte reads
+static void copy(uint8_t* dst, const volatile uint8_t* src, uint32_t length)
+{
+    if ((((uint32_t) dst | (uint32_t) src | length) & 3) == 0)
+    {
+        uint32_t* d = (uint32_t*) dst;
+        const volatile uint32_t* s = (const volatile uint32_t*) src;
+
+        for (length >>= 2; length > 0; length--)
+        {
+            *d++ = *s++;
+        }
+    }
+    else
+    {
+        while (length--)
+        {
+            *dst++ = *src++;
+        }
+    }
+}
+
+static burst_status_t burst_read(uint32_t address, uint32_t length, uint32_t* crc)
+{
+    burst_window_t* window = get_window();
+
+    if (((address + length) < address) || !is_legal_addr(address) || !is_legal_addr(address + length - 1) ||
+            is_secret(address, length) || is_read_protected(address, length))
+    {
+        return burst_err_addr;
+    }
+
+    copy(window->data, (const volatile uint8_t*) address, length);
+    *crc = crc32(window->data, length);
+
+    window->address = address;
+    window->length = (uint16_t) length;
+    window->crc = *crc;
+    window->seq++;
+
+    next_read = address + length;
+    return burst_ok;
+}
+
+static burst_status_t burst_write(uint32_t address, uint32_t length, const uint32_t* data, uint32_t crc)
+{
+    if (!is_ram(address) || !is_ram(address + length - 1) ||
+            !is_legal_addr(address) || !is_legal_addr(address + length - 1))
+    {
+        return burst_err_addr;
+    }
+    if (crc32(data, length) != crc)
+    {
+        return burst_err_crc;
+    }
+
+    copy((uint8_t*) address, (const volatile uint8_t*) data, length);
+
+    next_write = address + length;
+    return burst_ok;
+}
+
+burst_status_t burst_execute(uint32_t* req)
+{
+    uint32_t cmd = req[0];
+    uint32_t address = req[1];
+    uint32_t length = req[2];
+    uint32_t crc = req[3];
+    burst_status_t status;
+
+    if ((length == 0) || (length > BURST_MAX_LEN))
+    {
+        status = burst_err_len;
+    }
+    else if (cmd == BURST_CMD_READ)
+    {
+        if (address == BURST_ADDR_NEXT)
+        {
+            address = next_read;
+        }
+        status = burst_read(address, length, &crc);
+    }
+    else if (cmd == BURST_CMD_WRITE)
+    {
+        if (address == BURST_ADDR_NEXT)
+        {
+            address = next_write;
+        }
+        status = burst_write(address, length, &req[4], crc);
+    }
+    else
+    {
+        status = burst_err_cmd;
+    }
+
+    if (status != burst_ok)
+    {
+        perf_counters.session.request_errors++;
+        if (status == burst_err_crc)
+        {
+            perf_counters.session.crc_errors++;
+        }
+    }
+
+    req[0] = status;
+    req[1] = address;
+    req[2] = length;
+    req[3] = crc;
+
+    return status;
+}
+
+uint32_t burst_handler(Mailbox_t* mbx)
+{
+    uint32_t* req = &mbx->content[BURST_MBX_OFFSET];
+
+    perf_counters.session.requests++;
+    if (pipe_busy())
+    {
+        perf_counters.session.request_errors++;
+        req[0] = burst_err_busy;
+        return burst_err_busy;
+    }
+    return burst_execute(req);
+}
@@ -0,0 +1,150 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     charge_progress.c
+ *  @brief    Charge progress and ETA status for the reader app.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack NVM lib
+#include "shc_lib.h"
+
+// smack_sl project
+#include "smack_sl.h"
+#include "timebase.h"
+#include "nvm_persist.h"
+#include "vclamp_tuner.h"
+#include "charge_progress.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+charge_progress_t charge_progress;
+
+static uint32_t start_time;
+static uint32_t sample_time;
+static uint16_t start_level;
+static volatile bool sampling;
+
+
+//-------------------------------------------------------------
+
+// successive approximation with the SHC comparator, resolution 16 digits
+static uint16_t measure_level(void)
+{
+    uint16_t level = 0;
+
+    for (uint16_t bit = 0x800; bit >= 0x10; bit >>= 1)
+    {
+        if (shc_compare(shc_channel_ma, level | bit))
+        {
+            level |= bit;
+        }
+    }
+    return level;
+}
+
+static uint16_t clamp_ms(uint32_t ms)
+{
+    return (ms >= CHARGE_PROGRESS_UNKNOWN) ? (CHARGE_PROGRESS_UNKNOWN - 1) : (uint16_t) ms;
+}
+
+void charge_progress_init(void)
+{
+    charge_progress.threshold = get_threshold_from_voltage(MOTOR_THRESHOLD_VOLTAGE);
+    charge_progress.eta_ms = CHARGE_PROGRESS_UNKNOWN;
+    charge_progress.lock_phase = (*((volatile uint32_t*) LOCK_STATE_ADDR) == 1) ? LOCK_LOCKED : LOCK_UNLOCKED;
+}
+
+void charge_progress_start(void)
+{
+    start_time = timebase_now();
+    sample_time = start_time;
+    start_level = measure_level();
+    charge_progress.level = start_level;
+    charge_progress.pulse = 0;
+    sampling = true;
+}
+
+bool charge_progress_reached(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    bool reached;
+
+    // notify_tx measures in the NFC interrupt, the SHC holds one threshold at a time
+    __disable_irq();
+    reached = shc_compare(shc_channel_ma, charge_progress.threshold);
+    if (reached)
+    {
+        sampling = false;
+        charge_progress.level = charge_progress.threshold;
+        sample_time = timebase_now();
+    }
+    __set_PRIMASK(primask);
+    return reached;
+}
+
+void charge_progress_actuate(uint8_t pulse, uint8_t lock_phase)
+{
+    charge_progress.pulse = pulse;
+    charge_progress.lock_phase = lock_phase;
+}
+
+void charge_progress_notify_tx(uint16_t data_point_id)
+{
+    charge_progress_t* p = &charge_progress;
+    uint32_t sampled_ms = (sample_time - start_time) / TIMEBASE_TICKS_PER_MS;
+    uint32_t expected;
+
+    (void) data_point_id;
+
+    // measured on demand, not on every poll of the main loop
+    if (sampling)
+    {
+        p->level = measure_level();
+        sample_time = timebase_now();
+        sampled_ms = (sample_time - start_time) / TIMEBASE_TICKS_PER_MS;
+    }
+
+    p->state = (uint8_t) current_state;
+    p->elapsed_ms = clamp_ms(timebase_ms_since(start_time));
+
+    if (p->level >= p->threshold)
+    {
+        p->eta_ms = 0;
+    }
+    else if ((p->level > start_level) && (sampled_ms > 0))
+    {
+        // linear extrapolation of the rise since the start of harvesting, counted from now
+        expected = sampled_ms + (sampled_ms * (p->threshold - p->level)) / (p->level - start_level);
+        p->eta_ms = (expected > p->elapsed_ms) ? clamp_ms(expected - p->elapsed_ms) : 0;
+    }
+    else
+    {
+        // no rise seen yet: fall back to the charge time recorded for this field
+        expected = vclamp_tuner_expected_ms(vclamp_tuner_stats.rssi);
+        if (expected == VCLAMP_TUNER_UNKNOWN)
+        {
+            p->eta_ms = CHARGE_PROGRESS_UNKNOWN;
+        }
+        else
+        {
+            p->eta_ms = (expected > p->elapsed_ms) ? (uint16_t) (expected - p->elapsed_ms) : 0;
+        }
+    }
+}
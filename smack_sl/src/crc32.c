@@ -0,0 +1,50 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     crc32.c
+ *  @brief    CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320).
+ */
+
+// standard libs
+#include <stdint.h>
+
+// smack_sl project
+#include "crc32.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+static const uint32_t crc32_table[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+
+//-------------------------------------------------------------
+
+uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length)
+{
+    const uint8_t* p = (const uint8_t*) data;
+
+    while (length--)
+    {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc32_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_table[crc & 0x0F];
+    }
+    return crc;
+}
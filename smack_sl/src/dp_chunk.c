@@ -0,0 +1,207 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     dp_chunk.c
+ *  @brief    Chunked transfer of objects larger than a data point.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// smack_sl project
+#include "crc32.h"
+#include "dp_chunk.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+// the open write transfer
+static const dp_chunk_object_t* transfer;
+static uint32_t next;
+
+
+//-------------------------------------------------------------
+
+static const dp_chunk_object_t* find(const dp_chunk_object_t* table, uint16_t count, uint16_t id)
+{
+    uint16_t low = 0;
+    uint16_t high = count;
+
+    while (low < high)
+    {
+        uint16_t mid = (uint16_t) ((low + high) / 2U);
+
+        if (table[mid].id < id)
+        {
+            low = (uint16_t) (mid + 1U);
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return ((low < count) && (table[low].id == id)) ? &table[low] : NULL;
+}
+
+static uint32_t object_size(const dp_chunk_object_t* o)
+{
+    return ((o->used != NULL) && (*o->used <= o->size)) ? *o->used : o->size;
+}
+
+static dp_chunk_status_t info(const dp_chunk_object_t* o, uint32_t* req)
+{
+    uint32_t size;
+
+    if (o->notify_tx != NULL)
+    {
+        o->notify_tx(o->id);
+    }
+    size = object_size(o);
+
+    req[1] = size;
+    req[2] = (transfer == o) ? next : 0;
+    req[3] = crc32(o->value, size);
+    return dp_chunk_ok;
+}
+
+static dp_chunk_status_t read_chunk(const dp_chunk_object_t* o, uint32_t* req, uint32_t max_length)
+{
+    uint8_t* data = (uint8_t*) &req[DP_CHUNK_HEADER_WORDS];
+    uint32_t size = object_size(o);
+    uint32_t offset = req[1];
+    uint32_t length = req[2];
+
+    if ((offset > size) || (length > max_length))
+    {
+        return dp_chunk_err_range;
+    }
+    if (length > size - offset)
+    {
+        length = size - offset;
+    }
+
+    memcpy(data, (const uint8_t*) o->value + offset, length);
+    req[2] = length;
+    req[3] = crc32(data, length);
+    return dp_chunk_ok;
+}
+
+static dp_chunk_status_t write_chunk(const dp_chunk_object_t* o, uint32_t* req, uint32_t max_length)
+{
+    const uint8_t* data = (const uint8_t*) &req[DP_CHUNK_HEADER_WORDS];
+    uint32_t offset = req[1];
+    uint32_t length = req[2];
+
+    if ((o->flags & DP_CHUNK_WRITE) == 0)
+    {
+        return dp_chunk_err_access;
+    }
+    if ((length > max_length) || (offset > o->size) || (length > o->size - offset))
+    {
+        return dp_chunk_err_range;
+    }
+    if (offset == 0)
+    {
+        transfer = o;
+        next = 0;
+    }
+    else if ((transfer != o) || (offset > next))
+    {
+        return dp_chunk_err_order;
+    }
+    if (crc32(data, length) != req[3])
+    {
+        return dp_chunk_err_crc;
+    }
+
+    memcpy((uint8_t*) o->value + offset, data, length);
+    if (offset + length > next)
+    {
+        next = offset + length;
+    }
+    req[1] = next;
+    return dp_chunk_ok;
+}
+
+static dp_chunk_status_t commit(const dp_chunk_object_t* o, uint32_t* req)
+{
+    uint32_t length = req[1];
+
+    if ((o->flags & DP_CHUNK_WRITE) == 0)
+    {
+        return dp_chunk_err_access;
+    }
+    if ((transfer != o) || (length != next))
+    {
+        return dp_chunk_err_order;
+    }
+    // the transfer stays open, the reader may rewrite chunks and commit again
+    if (crc32(o->value, length) != req[3])
+    {
+        return dp_chunk_err_crc;
+    }
+
+    transfer = NULL;
+    if (o->used != NULL)
+    {
+        *o->used = length;
+    }
+    if (o->notify_rx != NULL)
+    {
+        o->notify_rx(o->id);
+    }
+    return dp_chunk_ok;
+}
+
+dp_chunk_status_t dp_chunk_execute(const dp_chunk_object_t* table, uint16_t count, uint32_t* req,
+                                   uint32_t max_length)
+{
+    uint32_t cmd = req[0] & DP_CHUNK_CMD_MASK;
+    const dp_chunk_object_t* o = find(table, count, (uint16_t) req[0]);
+    dp_chunk_status_t status;
+
+    if ((cmd != DP_CHUNK_CMD_INFO) && (cmd != DP_CHUNK_CMD_READ) && (cmd != DP_CHUNK_CMD_WRITE) &&
+        (cmd != DP_CHUNK_CMD_COMMIT))
+    {
+        status = dp_chunk_err_cmd;
+    }
+    else if (o == NULL)
+    {
+        status = dp_chunk_err_id;
+    }
+    else if (cmd == DP_CHUNK_CMD_INFO)
+    {
+        status = info(o, req);
+    }
+    else if (cmd == DP_CHUNK_CMD_READ)
+    {
+        status = read_chunk(o, req, max_length);
+    }
+    else if (cmd == DP_CHUNK_CMD_WRITE)
+    {
+        status = write_chunk(o, req, max_length);
+    }
+    else
+    {
+        status = commit(o, req);
+    }
+
+    req[0] = status;
+    return status;
+}
@@ -0,0 +1,408 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     dp_crypt.c
+ *  @brief    Encrypted and authenticated exchange of the data points marked data_point_encrypt.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// Smack NVM lib
+#include "aes_lib.h"
+#include "smack_exchange.h"
+
+// smack_sl project
+#include "timebase.h"
+#include "aes_key.h"
+#include "dp_crypt.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+#define CCM_FLAGS_B0        0x59U       // additional data, M = 8, L = 2
+#define CCM_FLAGS_A         0x01U       // L = 2
+#define AAD_LEN             20U         // request words +0...+4
+
+dp_crypt_stats_t dp_crypt_stats;
+
+#ifdef DP_CRYPT_BENCHMARK
+dp_crypt_bench_t dp_crypt_bench;
+#endif
+
+static const data_point_entry_t* points;
+static uint16_t point_count;
+static const aes_block_t* crypt_key;
+static uint32_t session[2];             // 64 bit, low word first
+static uint32_t last_counter;
+
+
+//-------------------------------------------------------------
+
+static void put_le32(uint8_t* dst, uint32_t value)
+{
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        dst[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static void make_nonce(uint8_t* nonce, uint8_t direction, uint32_t counter)
+{
+    nonce[0] = direction;
+    put_le32(&nonce[1], session[0]);
+    put_le32(&nonce[5], session[1]);
+    put_le32(&nonce[9], counter);
+}
+
+// B0 or A_i of CCM: flags, nonce and a 16 bit big endian number
+static void make_block(aes_block_t* block, uint8_t flags, const uint8_t* nonce, uint32_t value)
+{
+    block->b[0] = flags;
+    memcpy(&block->b[1], nonce, DP_CRYPT_NONCE_LEN);
+    block->b[14] = (uint8_t) (value >> 8);
+    block->b[15] = (uint8_t) value;
+}
+
+// CBC-MAC over data, the last block zero padded
+static void mac_update(aes_block_t* x, const uint8_t* data, uint32_t length)
+{
+    while (length > 0)
+    {
+        uint32_t n = (length < 16) ? length : 16;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            x->b[i] ^= data[i];
+        }
+        calc_aes_ba(x, x, encrypt);
+        data += n;
+        length -= n;
+    }
+}
+
+// counter mode from A_1, encrypts and decrypts in place
+static void ctr_crypt(const uint8_t* nonce, uint8_t* data, uint32_t length)
+{
+    aes_block_t s;
+
+    for (uint32_t counter = 1; length > 0; counter++)
+    {
+        uint32_t n = (length < 16) ? length : 16;
+
+        make_block(&s, CCM_FLAGS_A, nonce, counter);
+        calc_aes_ba(&s, &s, encrypt);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            data[i] ^= s.b[i];
+        }
+        data += n;
+        length -= n;
+    }
+}
+
+// CCM tag of the plain value, the tag is encrypted with A_0
+static void ccm_tag(const uint8_t* nonce, const uint8_t* aad, const uint8_t* data, uint32_t length, uint8_t* tag)
+{
+    aes_block_t x;
+    aes_block_t s;
+    uint8_t header[2 + AAD_LEN];
+
+    make_block(&x, CCM_FLAGS_B0, nonce, length);
+    calc_aes_ba(&x, &x, encrypt);
+    header[0] = 0;
+    header[1] = AAD_LEN;
+    memcpy(&header[2], aad, AAD_LEN);
+    mac_update(&x, header, sizeof(header));
+    mac_update(&x, data, length);
+
+    make_block(&s, CCM_FLAGS_A, nonce, 0);
+    calc_aes_ba(&s, &s, encrypt);
+    for (uint32_t i = 0; i < DP_CRYPT_TAG_LEN; i++)
+    {
+        tag[i] = x.b[i] ^ s.b[i];
+    }
+}
+
+// compares all bytes, the time does not depend on the position of a difference
+static bool tag_equal(const uint8_t* a, const uint8_t* b)
+{
+    uint8_t diff = 0;
+
+    for (uint32_t i = 0; i < DP_CRYPT_TAG_LEN; i++)
+    {
+        diff |= (uint8_t) (a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+static const data_point_entry_t* find(uint16_t id)
+{
+    uint16_t low = 0;
+    uint16_t high = point_count;
+
+    while (low < high)
+    {
+        uint16_t mid = (uint16_t) ((low + high) / 2U);
+
+        if (points[mid].data_point_id < id)
+        {
+            low = (uint16_t) (mid + 1U);
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if ((low < point_count) && (points[low].data_point_id == id) && ((points[low].data_type & data_point_encrypt) != 0))
+    {
+        return &points[low];
+    }
+    return NULL;
+}
+
+static bool is_string(const data_point_entry_t* e)
+{
+    return (e->data_type & DATA_POINT_TYPE_MASK) == data_point_string;
+}
+
+static uint32_t string_length(const data_point_entry_t* e)
+{
+    const char* s = (const char*) e->value;
+    uint32_t length = 0;
+
+    while ((length < e->length) && (s[length] != '\0'))
+    {
+        length++;
+    }
+    return length;
+}
+
+static uint32_t value_length(const data_point_entry_t* e)
+{
+    switch (e->data_type & DATA_POINT_TYPE_MASK)
+    {
+        case data_point_bool:
+        case data_point_int8:
+        case data_point_uint8:
+            return 1;
+        case data_point_int16:
+        case data_point_uint16:
+            return 2;
+        case data_point_int32:
+        case data_point_uint32:
+            return 4;
+        case data_point_int64:
+        case data_point_uint64:
+            return 8;
+        case data_point_string:
+            return string_length(e);
+        default:
+            return e->length;
+    }
+}
+
+static dp_crypt_status_t read_point(const data_point_entry_t* e, uint32_t* req, uint8_t* data)
+{
+    uint8_t nonce[DP_CRYPT_NONCE_LEN];
+    uint32_t length;
+
+    if (e->notify_tx != NULL)
+    {
+        e->notify_tx(e->data_point_id);
+    }
+    length = value_length(e);
+    if (length > DP_CRYPT_MAX_LEN)
+    {
+        return dp_crypt_err_len;
+    }
+
+    req[2] = session[0];
+    req[3] = session[1];
+    req[4] = length;
+    memcpy(data, e->value, length);
+
+    make_nonce(nonce, 1, req[1]);
+    ccm_tag(nonce, (const uint8_t*) req, data, length, (uint8_t*) &req[5]);
+    ctr_crypt(nonce, data, length);
+    last_counter = req[1];
+
+    return dp_crypt_ok;
+}
+
+static dp_crypt_status_t write_point(const data_point_entry_t* e, uint32_t* req, uint8_t* data)
+{
+    uint8_t nonce[DP_CRYPT_NONCE_LEN];
+    uint8_t tag[DP_CRYPT_TAG_LEN];
+    uint32_t length = req[4];
+
+    if ((e->data_type & data_point_write) == 0)
+    {
+        return dp_crypt_err_access;
+    }
+    if ((length > DP_CRYPT_MAX_LEN) || (is_string(e) ? (length > e->length) : (length != value_length(e))))
+    {
+        return dp_crypt_err_len;
+    }
+
+    make_nonce(nonce, 0, req[1]);
+    ctr_crypt(nonce, data, length);
+    ccm_tag(nonce, (const uint8_t*) req, data, length, tag);
+    if (!tag_equal(tag, (const uint8_t*) &req[5]))
+    {
+        memset(data, 0, length);
+        dp_crypt_stats.auth_failures++;
+        return dp_crypt_err_auth;
+    }
+    last_counter = req[1];
+
+    memcpy(e->value, data, length);
+    if (is_string(e))
+    {
+        // as the data exchange library, the string buffer has room for length + 1 bytes
+        ((uint8_t*) e->value)[length] = 0;
+    }
+    // the plain value does not stay readable in the mailbox
+    memset(data, 0, length);
+
+    if (e->notify_rx != NULL)
+    {
+        e->notify_rx(e->data_point_id);
+    }
+    return dp_crypt_ok;
+}
+
+void dp_crypt_init(const data_point_entry_t* table, uint16_t count, const aes_block_t* key)
+{
+    uint32_t random[4];
+
+    points = table;
+    point_count = count;
+    crypt_key = key;
+
+    // the counter starts again with every session, the nonces stay unique as long as the 64 bit
+    // sessions do not repeat
+    aes_key_random(random);
+    session[0] = random[0];
+    session[1] = random[1];
+    last_counter = 0;
+}
+
+dp_crypt_status_t dp_crypt_handler(Mailbox_t* mbx)
+{
+    uint32_t* req = &mbx->content[DP_CRYPT_MBX_OFFSET];
+    uint8_t* data = (uint8_t*) &req[DP_CRYPT_HEADER_WORDS];
+    uint32_t cmd = req[0] & DP_CRYPT_CMD_MASK;
+    const data_point_entry_t* e = find((uint16_t) req[0]);
+    dp_crypt_status_t status;
+
+    dp_crypt_stats.requests++;
+
+    if ((cmd != DP_CRYPT_CMD_READ) && (cmd != DP_CRYPT_CMD_WRITE))
+    {
+        status = dp_crypt_err_cmd;
+    }
+    else if (e == NULL)
+    {
+        status = dp_crypt_err_id;
+    }
+    else if ((cmd == DP_CRYPT_CMD_WRITE) && ((req[2] != session[0]) || (req[3] != session[1])))
+    {
+        dp_crypt_stats.replays++;
+        status = dp_crypt_err_session;
+    }
+    else if (req[1] <= last_counter)
+    {
+        dp_crypt_stats.replays++;
+        status = dp_crypt_err_replay;
+    }
+    else
+    {
+        aes_key_use(crypt_key);
+        status = (cmd == DP_CRYPT_CMD_READ) ? read_point(e, req, data) : write_point(e, req, data);
+    }
+
+    req[0] = status;
+    return status;
+}
+
+void dp_crypt_notify_tx(uint16_t data_point_id)
+{
+    (void) data_point_id;
+    dp_crypt_stats.key = aes_key_stats;
+}
+
+#ifdef DP_CRYPT_BENCHMARK
+
+void dp_crypt_benchmark(void)
+{
+    static const uint16_t lengths[DP_CRYPT_BENCH_LENGTHS] = { 4, 16, 32, 64, DP_CRYPT_MAX_LEN };
+    static const aes_block_t key_a = { { 0x00 } };
+    static const aes_block_t key_b = { { 0x01 } };
+    static uint32_t aad[AAD_LEN / 4];
+    static uint8_t value[DP_CRYPT_MAX_LEN];
+    static uint8_t buffer[DP_CRYPT_MAX_LEN];
+    uint8_t nonce[DP_CRYPT_NONCE_LEN];
+    uint8_t tag[DP_CRYPT_TAG_LEN];
+    uint8_t check[DP_CRYPT_TAG_LEN];
+    uint32_t primask = __get_PRIMASK();
+    uint32_t start;
+
+    // the NFC handlers use the AES unit as well
+    __disable_irq();
+
+    aes_key_use(&key_a);
+    start = timebase_now();
+    aes_key_use(&key_b);
+    dp_crypt_bench.key_load = (uint16_t) timebase_ticks_since(start);
+    start = timebase_now();
+    aes_key_use(&key_b);
+    dp_crypt_bench.key_skip = (uint16_t) timebase_ticks_since(start);
+
+    make_nonce(nonce, 1, 1);
+    for (uint32_t i = 0; i < DP_CRYPT_BENCH_LENGTHS; i++)
+    {
+        dp_crypt_bench_entry_t* e = &dp_crypt_bench.entry[i];
+        uint32_t length = lengths[i];
+
+        e->length = (uint16_t) length;
+
+        start = timebase_now();
+        memcpy(buffer, value, length);
+        e->copy = (uint16_t) timebase_ticks_since(start);
+
+        start = timebase_now();
+        ccm_tag(nonce, (const uint8_t*) aad, buffer, length, tag);
+        ctr_crypt(nonce, buffer, length);
+        e->seal = (uint16_t) timebase_ticks_since(start);
+
+        start = timebase_now();
+        ctr_crypt(nonce, buffer, length);
+        ccm_tag(nonce, (const uint8_t*) aad, buffer, length, check);
+        (void) tag_equal(tag, check);
+        e->open = (uint16_t) timebase_ticks_since(start);
+    }
+
+    __set_PRIMASK(primask);
+}
+
+#endif /* DP_CRYPT_BENCHMARK */
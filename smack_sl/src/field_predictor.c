@@ -0,0 +1,120 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     field_predictor.c
+ *  @brief    Go/no-go decision based on field strength and recorded charge times.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "smack_sl.h"
+#include "vclamp_tuner.h"
+#include "field_predictor.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+field_predictor_stats_t field_predictor_stats;
+
+
+//-------------------------------------------------------------
+
+static uint16_t get_average(sense_nfc_sel_t sel)
+{
+    uint32_t sum = 0;
+
+    for (uint8_t i = 0; i < FIELD_PREDICTOR_SAMPLES; i++)
+    {
+        sum += get_nfc_value(sel);
+    }
+    return (uint16_t) (sum / FIELD_PREDICTOR_SAMPLES);
+}
+
+static field_decision_t decide(void)
+{
+    field_predictor_stats_t* stats = &field_predictor_stats;
+    uint32_t predicted;
+
+    if (stats->vccca < FIELD_PREDICTOR_VCCCA_MIN)
+    {
+        if (stats->delays < FIELD_PREDICTOR_MAX_DELAYS)
+        {
+            stats->delays++;
+            return field_decision_delay;
+        }
+        return field_decision_move_closer;
+    }
+    if (stats->rssi < FIELD_PREDICTOR_RSSI_MIN)
+    {
+        return field_decision_move_closer;
+    }
+
+    // the charge just measured, else the record for this field strength
+    stats->charge_ms = vclamp_tuner_stats.charge_ms;
+    if (stats->charge_ms == VCLAMP_TUNER_UNKNOWN)
+    {
+        stats->charge_ms = vclamp_tuner_expected_ms(stats->rssi);
+    }
+    // without either, the attempt is the only way to learn
+    if (stats->charge_ms == VCLAMP_TUNER_UNKNOWN)
+    {
+        stats->predicted_ms = 0;
+        return field_decision_go;
+    }
+
+    predicted = ((uint32_t) stats->charge_ms * MAX_MOTOR_ROTATIONS * FIELD_PREDICTOR_PULSE_SHARE) / 100UL;
+    stats->predicted_ms = (predicted > 0xFFFFUL) ? 0xFFFF : (uint16_t) predicted;
+    if (predicted > FIELD_PREDICTOR_BUDGET_MS)
+    {
+        return field_decision_move_closer;
+    }
+    return field_decision_go;
+}
+
+field_decision_t field_predictor_evaluate(void)
+{
+    field_predictor_stats_t* stats = &field_predictor_stats;
+    field_decision_t decision;
+
+    stats->rssi = get_average(nfc_sel_rssi);
+    stats->vccca = get_average(nfc_sel_vdd_ca);
+
+    decision = decide();
+    stats->decision = (uint8_t) decision;
+
+    switch (decision)
+    {
+        case field_decision_go:
+            stats->delays = 0;
+            stats->go_count++;
+            break;
+
+        case field_decision_delay:
+            stats->delay_count++;
+            break;
+
+        default:
+            stats->delays = 0;
+            stats->weak_count++;
+            break;
+    }
+    return decision;
+}
@@ -0,0 +1,133 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     image_check.c
+ *  @brief    Integrity check of the NVM image against the CRC stamped into the version section.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "version.h"
+#include "crc32.h"
+#include "timebase.h"
+#include "nvm_persist.h"
+#include "vclamp_tuner.h"
+#include "perf.h"
+#include "image_check.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+image_check_stats_t image_check_stats;
+
+static uint32_t running_crc;
+
+
+//-------------------------------------------------------------
+
+static void finish(void)
+{
+    image_check_stats_t* s = &image_check_stats;
+
+    s->calculated = crc32_final(running_crc);
+    if (s->calculated != s->expected)
+    {
+        s->status = image_check_failed;
+        return;
+    }
+
+    s->status = image_check_ok;
+    if (nvm_persist_open() == 0)
+    {
+        *((volatile uint32_t*) IMAGE_CRC_CACHE_ADDR) = s->calculated;
+        (void) vclamp_tuner_stage();
+        perf_stage();
+        (void) nvm_persist_commit();
+    }
+}
+
+void image_check_init(void)
+{
+    image_check_stats_t* s = &image_check_stats;
+    uint32_t start = timebase_now();
+
+    s->expected = version.crc;
+    s->offset = 0;
+    running_crc = CRC32_INIT;
+
+    nvm_config();
+    // not stamped: initial value of version.c, or the version page erased
+    if ((s->expected == 0) || (s->expected == 0xFFFFFFFFUL))
+    {
+        s->status = image_check_unstamped;
+    }
+    else if (*((volatile uint32_t*) IMAGE_CRC_CACHE_ADDR) == s->expected)
+    {
+        s->calculated = s->expected;
+        s->status = image_check_cached;
+    }
+    else
+    {
+        s->status = image_check_running;
+#ifdef IMAGE_CHECK_BLOCKING
+        while (image_check_step())
+        {
+            ;
+        }
+#endif
+    }
+
+    s->boot_ticks = timebase_ticks_since(start);
+}
+
+bool image_check_step(void)
+{
+    image_check_stats_t* s = &image_check_stats;
+    uint32_t start;
+    uint32_t length = IMAGE_CHECK_STEP;
+    uint32_t address;
+
+    if (s->status != image_check_running)
+    {
+        return false;
+    }
+
+    start = timebase_now();
+    address = IMAGE_CHECK_START + s->offset;
+    if ((address + length) > IMAGE_CHECK_END)
+    {
+        length = IMAGE_CHECK_END - address;
+    }
+    // steps are aligned to the device data, which is skipped as a whole
+    if ((address < IMAGE_DEVICE_START) || (address >= IMAGE_DEVICE_END))
+    {
+        running_crc = crc32_update(running_crc, (const void*) address, length);
+    }
+    s->offset += (uint16_t) length;
+
+    if ((address + length) >= IMAGE_CHECK_END)
+    {
+        finish();
+    }
+    s->check_ticks += timebase_ticks_since(start);
+
+    return (s->status == image_check_running);
+}
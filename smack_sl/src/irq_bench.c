@@ -0,0 +1,136 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     irq_bench.c
+ *  @brief    Entry latency of the interrupt routes through the ROM dispatch.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack NVM lib
+#include "sys_tim_lib.h"
+
+// smack_sl project
+#include "timebase.h"
+#include "irq_map.h"
+#include "irq_bench.h"
+
+#ifdef IRQ_BENCHMARK
+
+#if (IRQ_MAP_HP13 != PM5_IRQ_HAND) || (IRQ_MAP_EVBUS7 != TIMER5_IRQ_HAND)
+#error "irq_map.h does not route the benchmark lines to system timer 5"
+#endif
+
+//-------------------------------------------------------------
+// globals/statics
+
+#define BENCH_IRQ_HP        ((IRQn_Type) IRQ_BENCH_LINE)
+
+irq_bench_t irq_bench;
+
+static volatile bool fired;
+static volatile uint32_t entry;
+
+
+//-------------------------------------------------------------
+
+static uint32_t wait_entry(void)
+{
+    while (!fired)
+    {
+        ;
+    }
+    fired = false;
+    return entry;
+}
+
+static void record(irq_route_t route, uint32_t start, uint32_t end, uint32_t offset)
+{
+    irq_bench_route_t* r = &irq_bench.route[route];
+    uint32_t ticks = end - start;
+
+    ticks = (ticks > offset) ? (ticks - offset) : 0;
+    if (ticks > UINT16_MAX)
+    {
+        ticks = UINT16_MAX;
+    }
+    if ((irq_bench.samples == 0) || (ticks < r->min))
+    {
+        r->min = (uint16_t) ticks;
+    }
+    if (ticks > r->max)
+    {
+        r->max = (uint16_t) ticks;
+    }
+    r->total += ticks;
+}
+
+void irq_bench_handler(void)
+{
+    entry = timebase_now();
+    fired = true;
+}
+
+void irq_bench_run(void)
+{
+    uint32_t overhead = UINT32_MAX;
+    uint32_t start;
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        start = timebase_now();
+        start = timebase_now() - start;
+        if (start < overhead)
+        {
+            overhead = start;
+        }
+    }
+    irq_bench.overhead = (uint16_t) overhead;
+    irq_bench.samples = 0;
+    for (uint8_t r = 0; r < (uint8_t) irq_route_count; r++)
+    {
+        irq_bench.route[r].min = 0;
+        irq_bench.route[r].max = 0;
+        irq_bench.route[r].total = 0;
+    }
+
+    fired = false;
+    NVIC_EnableIRQ(Event_Bus7_IRQn);
+    NVIC_EnableIRQ(BENCH_IRQ_HP);
+
+    for (uint16_t s = 0; s < IRQ_BENCH_SAMPLES; s++)
+    {
+        start = timebase_now();
+        NVIC_SetPendingIRQ(Event_Bus7_IRQn);
+        record(irq_route_evbus, start, wait_entry(), overhead);
+
+        start = timebase_now();
+        NVIC_SetPendingIRQ(BENCH_IRQ_HP);
+        record(irq_route_hp, start, wait_entry(), overhead);
+
+        // the helper waits for the timer, the handler has run when it returns
+        start = timebase_now();
+        sys_tim_singleshot(IRQ_BENCH_CHANNEL, IRQ_BENCH_PERIOD, IRQ_BENCH_LINE);
+        record(irq_route_hp_timer, start, wait_entry(), overhead + IRQ_BENCH_PERIOD);
+
+        irq_bench.samples++;
+    }
+
+    NVIC_DisableIRQ(Event_Bus7_IRQn);
+    NVIC_DisableIRQ(BENCH_IRQ_HP);
+}
+
+#endif /* IRQ_BENCHMARK */
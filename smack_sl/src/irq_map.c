@@ -0,0 +1,60 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     irq_map.c
+ *  @brief    Routing of the interrupt sources to the NVIC lines and their priorities.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// smack_sl project
+#include "irq_map.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+typedef struct
+{
+    IRQn_Type irq;
+    uint8_t   priority;
+} irq_priority_t;
+
+static const irq_priority_t priorities[] =
+{
+    {HPrio_Matrix0_IRQn,    IRQ_MAP_HP9_PRIO},
+    {HPrio_Matrix1_IRQn,    IRQ_MAP_HP10_PRIO},
+    {HPrio_Matrix2_IRQn,    IRQ_MAP_HP11_PRIO},
+    {HPrio_Matrix3_IRQn,    IRQ_MAP_HP12_PRIO},
+    {HPrio_Matrix4_IRQn,    IRQ_MAP_HP13_PRIO},
+    {HPrio_Matrix5_IRQn,    IRQ_MAP_HP14_PRIO},
+    {Event_Bus7_IRQn,       IRQ_MAP_EVBUS7_PRIO},
+    {Event_Bus8_IRQn,       IRQ_MAP_EVBUS8_PRIO},
+};
+
+
+//-------------------------------------------------------------
+
+void irq_map_init(void)
+{
+    for (uint8_t i = 0; i < (sizeof(priorities) / sizeof(priorities[0])); i++)
+    {
+        NVIC_SetPriority(priorities[i].irq, priorities[i].priority);
+    }
+
+    // the bottom half is pended by app functions which run before any data exchange set up (mbx_pipe.h)
+    NVIC_EnableIRQ(Event_Bus8_IRQn);
+}
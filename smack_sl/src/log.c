@@ -0,0 +1,161 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     log.c
+ *  @brief    Binary debug log on the UART, formatted on the host.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "power.h"
+#include "uart_regs.h"
+#include "log.h"
+
+#ifdef UART_LOG
+
+//-------------------------------------------------------------
+// globals/statics
+
+#define LOG_TX_LEVEL        1               //!< TX interrupt when the FIFO is 1/4 full
+#define LOG_BYTES           (LOG_SIZE * 4)
+
+static uint32_t ring[LOG_SIZE];
+static uint32_t head;                       // bytes written
+static uint32_t tail;                       // bytes sent
+static uint32_t lost;                       // dropped messages not reported yet
+static bool powered;                        // UART power domain acquired
+
+log_stats_t log_stats;
+
+
+//-------------------------------------------------------------
+
+// to be called with interrupts disabled
+static void fill_fifo(void)
+{
+    const uint8_t* bytes = (const uint8_t*) ring;
+
+    while ((tail != head) && ((UART_FR & UART_FR_TXFF) == 0))
+    {
+        UART_DR = bytes[tail & (LOG_BYTES - 1)];
+        tail++;
+    }
+    if (tail == head)
+    {
+        UART_IMSC &= ~UART_IMSC_TXIM;
+    }
+    else
+    {
+        UART_IMSC |= UART_IMSC_TXIM;
+    }
+}
+
+static bool put(uint32_t header, const uint32_t* args)
+{
+    uint32_t count = (header >> 16) & 0xFF;
+    uint32_t used = head - (tail & ~3UL);
+
+    if ((LOG_BYTES - used) < ((count + 1) * 4))
+    {
+        return false;
+    }
+    ring[(head / 4) & (LOG_SIZE - 1)] = header;
+    head += 4;
+    while (count-- != 0)
+    {
+        ring[(head / 4) & (LOG_SIZE - 1)] = *args++;
+        head += 4;
+    }
+    return true;
+}
+
+void log_init(void)
+{
+    power_acquire(power_domain_uart);
+    powered = true;
+    set_uart_baudrate(LOG_BAUDRATE);
+    init_uart(false, even, false, true, uart_bits_8, false);
+    set_uart_control(true, false, true);
+    // the TX interrupt is enabled while the ring holds data
+    configure_uart_irq(LOG_UART_IRQ, 0, LOG_TX_LEVEL, false, false);
+}
+
+void log_write(uint32_t header, const uint32_t* args)
+{
+    uint32_t primask = __get_PRIMASK();
+    bool idle;
+
+    __disable_irq();
+    idle = (tail == head);
+    if (lost != 0)
+    {
+        if (put(LOG_HEADER(LOG_ID_DROPPED, 1), &lost))
+        {
+            lost = 0;
+        }
+    }
+    if ((lost == 0) && put(header, args))
+    {
+        log_stats.messages++;
+    }
+    else
+    {
+        log_stats.dropped++;
+        lost++;
+    }
+    // the TX interrupt only fires when the FIFO level drops, so the first bytes are written here
+    if (idle)
+    {
+        // switched off by log_poll() after the last message, the configuration is kept
+        if (!powered)
+        {
+            power_acquire(power_domain_uart);
+            set_uart_control(true, false, true);
+            powered = true;
+        }
+        fill_fifo();
+    }
+    __set_PRIMASK(primask);
+}
+
+void log_poll(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    // the ring and the FIFO are empty and the last byte has left the shift register
+    if (powered && (tail == head) && ((UART_FR & UART_FR_BUSY) == 0))
+    {
+        powered = false;
+        power_release(power_domain_uart);
+    }
+    __set_PRIMASK(primask);
+}
+
+void log_uart_handler(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    fill_fifo();
+    __set_PRIMASK(primask);
+}
+
+#endif /* UART_LOG */
@@ -0,0 +1,171 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     mbx_pipe.c
+ *  @brief    Two slot mailbox, the reader writes the next request while the previous one executes.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "perf.h"
+#include "burst.h"
+#include "ota.h"
+#include "dp_chunk.h"
+#include "smack_dataexchange.h"
+#include "mbx_pipe.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+pipe_stats_t pipe_stats;
+
+static uint8_t next_seq;
+static volatile bool running;
+
+
+//-------------------------------------------------------------
+
+// header of slot i, written by the NFC handler while the bottom half runs
+static volatile uint32_t* get_slot(Mailbox_t* mbx, uint32_t i)
+{
+    return &mbx->content[PIPE_MBX_OFFSET + i * PIPE_SLOT_WORDS];
+}
+
+static uint32_t get_state(uint32_t header)
+{
+    return header >> 24;
+}
+
+// the ready slot with the expected sequence number, else the oldest ready one
+static volatile uint32_t* next_slot(Mailbox_t* mbx)
+{
+    volatile uint32_t* oldest = NULL;
+
+    for (uint32_t i = 0; i < PIPE_SLOTS; i++)
+    {
+        volatile uint32_t* slot = get_slot(mbx, i);
+        uint32_t header = *slot;
+
+        if (get_state(header) != PIPE_READY)
+        {
+            continue;
+        }
+        if ((uint8_t) header == next_seq)
+        {
+            return slot;
+        }
+        if ((oldest == NULL) || ((int8_t) (uint8_t) (header - *oldest) < 0))
+        {
+            oldest = slot;
+        }
+    }
+
+    if (oldest != NULL)
+    {
+        pipe_stats.resyncs++;
+    }
+    return oldest;
+}
+
+static uint32_t execute(uint32_t* req)
+{
+    uint32_t cmd = req[0];
+
+    if ((cmd == BURST_CMD_READ) || (cmd == BURST_CMD_WRITE))
+    {
+        return burst_execute(req);
+    }
+    if ((cmd >> 16) == (OTA_CMD_BEGIN >> 16))
+    {
+        // the slot is shorter than the OTA request area
+        if ((cmd == OTA_CMD_DATA) && ((req[2] & 0xFFFFU) > PIPE_MAX_PAYLOAD))
+        {
+            req[0] = ota_err_range;
+            return ota_err_range;
+        }
+        return ota_execute(req);
+    }
+    if (DP_CHUNK_IS_CMD(cmd))
+    {
+        return data_exchange_chunk_execute(req, PIPE_MAX_PAYLOAD * 4U);
+    }
+    return PIPE_ERR_CMD;
+}
+
+// slots in PIPE_READY or PIPE_BUSY
+static uint32_t get_owned(Mailbox_t* mbx)
+{
+    uint32_t owned = 0;
+
+    for (uint32_t i = 0; i < PIPE_SLOTS; i++)
+    {
+        uint32_t state = get_state(*get_slot(mbx, i));
+
+        if ((state == PIPE_READY) || (state == PIPE_BUSY))
+        {
+            owned++;
+        }
+    }
+    return owned;
+}
+
+bool pipe_busy(void)
+{
+    return get_owned(get_mailbox_address()) != 0;
+}
+
+uint32_t pipe_handler(Mailbox_t* mbx)
+{
+    uint32_t owned = get_owned(mbx);
+
+    perf_counters.session.requests++;
+    if (running && (owned > 1))
+    {
+        pipe_stats.overlapped++;
+    }
+
+    data_exchange_schedule();
+    return owned;
+}
+
+void pipe_run(void)
+{
+    Mailbox_t* mbx = get_mailbox_address();
+    volatile uint32_t* slot;
+
+    running = true;
+    while ((slot = next_slot(mbx)) != NULL)
+    {
+        uint8_t seq = (uint8_t) *slot;
+        uint32_t status;
+
+        *slot = PIPE_HEADER(PIPE_BUSY, 0, seq);
+        status = execute((uint32_t*) &slot[1]);
+
+        // reply before header, the reader takes the slot back as soon as it sees PIPE_DONE
+        __DMB();
+        *slot = PIPE_HEADER(PIPE_DONE, status, seq);
+        next_seq = (uint8_t) (seq + 1U);
+        pipe_stats.executed++;
+    }
+    running = false;
+}
@@ -0,0 +1,125 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     ndef_tag.c
+ *  @brief    RAM backed NFC Forum Type 2 Tag with a status text record.
+ */
+
+// standard libs
+#include <stddef.h>
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "smack_sl.h"
+#include "version.h"
+#include "nvm_persist.h"
+#include "ndef_tag.h"
+#include "aes_key.h"
+
+
+//-------------------------------------------------------------
+// Definitions
+
+#define HEX_CHAR(n)         ((char) ((((n) & 0xF) < 10) ? ('0' + ((n) & 0xF)) : ('A' + ((n) & 0xF) - 10)))
+
+// lengths derived from the layout, so the header bytes follow any change of the text
+#define NDEF_PAYLOAD_LEN    (offsetof(ndef_tag_t, terminator) - offsetof(ndef_tag_t, lang))
+#define NDEF_MESSAGE_LEN    (offsetof(ndef_tag_t, terminator) - offsetof(ndef_tag_t, record))
+#define NDEF_DATA_AREA_LEN  (offsetof(ndef_tag_t, ext) - offsetof(ndef_tag_t, tlv))
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+ndef_tag_t ndef_tag;
+
+static const ndef_tag_t ndef_tag_template =
+{
+    .header = {0x05, 0xc0, 0xbe, 0xef, 0xde, 0xad, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff},
+    .cc = {0xE1, 0x10, (uint8_t) (NDEF_DATA_AREA_LEN / 8), 0x0f},
+    .tlv = {0x03, (uint8_t) NDEF_MESSAGE_LEN},
+    .record = {0xd1, 0x01, (uint8_t) NDEF_PAYLOAD_LEN, 'T'},
+    .lang = {0x02, 'e', 'n'},
+    .lock_label = "Lock:",
+    .lock = '?',
+    .event_label = " Event:",
+    .event = "00",
+    .nonce_label = " Nonce:",
+    .nonce = "00000000",
+    .fw =
+    {
+        ' ', 'F', 'W', ':', 'V',
+        HEX_CHAR(FW_VERSION_MAJOR), '.', HEX_CHAR(FW_VERSION_MINOR), '.',
+        HEX_CHAR(FW_VERSION_STEP >> 12), HEX_CHAR(FW_VERSION_STEP >> 8),
+        HEX_CHAR(FW_VERSION_STEP >> 4), HEX_CHAR(FW_VERSION_STEP)
+    },
+    .terminator = 0xfe,
+    .rfu = {0x00, 0x00, 0x00}
+};
+
+static const char lock_char[] = {'L', 'u', 'U', 'l'};   // indexed by Lock_State_enum_t
+
+
+//-------------------------------------------------------------
+
+static void to_hex(char* dst, uint32_t value, uint8_t digits)
+{
+    while (digits > 0)
+    {
+        digits--;
+        dst[digits] = HEX_CHAR(value);
+        value >>= 4;
+    }
+}
+
+void ndef_tag_init(void)
+{
+    const uint8_t* src = (const uint8_t*) &ndef_tag_template;
+    uint8_t* dst = (uint8_t*) &ndef_tag;
+
+    // the extension area is zero initialized in RAM already
+    for (uint8_t i = 0; i < offsetof(ndef_tag_t, ext); i++)
+    {
+        dst[i] = src[i];
+    }
+    ndef_tag_set_lock((*((volatile uint32_t*) LOCK_STATE_ADDR) == 1) ? LOCK_LOCKED : LOCK_UNLOCKED);
+    ndef_tag_new_nonce();
+}
+
+void ndef_tag_set_lock(uint8_t lock_phase)
+{
+    if (lock_phase < sizeof(lock_char))
+    {
+        ndef_tag.lock = lock_char[lock_phase];
+    }
+}
+
+void ndef_tag_set_event(ndef_event_t event)
+{
+    to_hex(ndef_tag.event, (uint32_t) event, sizeof(ndef_tag.event));
+}
+
+uint32_t ndef_tag_new_nonce(void)
+{
+    uint32_t random[4];
+
+    aes_key_random(random);
+    to_hex(ndef_tag.nonce, random[0], sizeof(ndef_tag.nonce));
+
+    return random[0];
+}
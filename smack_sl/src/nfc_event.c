@@ -0,0 +1,49 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     nfc_event.c
+ *  @brief    Application events of the NFC interface, handed from the NFC interrupt to the main loop.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// smack_sl project
+#include "ring.h"
+#include "nfc_event.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+static EVENT_QUEUE_T(NFC_EVENT_SIZE) events;
+
+
+//-------------------------------------------------------------
+
+void nfc_event_post(nfc_event_t event, uint16_t arg)
+{
+    (void) EVENT_POST(events, event, arg);
+}
+
+bool nfc_event_get(ring_event_t* e)
+{
+    return EVENT_GET(events, e);
+}
+
+uint16_t nfc_event_lost(void)
+{
+    return events.lost;
+}
@@ -0,0 +1,65 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     nvm_persist.c
+ *  @brief    Read-modify-write access to the persistent NVM page.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "timebase.h"
+#include "perf.h"
+#include "nvm_persist.h"
+
+
+//-------------------------------------------------------------
+
+uint8_t nvm_persist_open(void)
+{
+    nvm_config();
+    return nvm_open_assembly_buffer(NVM_PERSIST_PAGE);
+}
+
+uint8_t nvm_persist_commit(void)
+{
+    uint8_t err;
+
+    err = nvm_write_page();
+    nvm_config();
+
+    return err;
+}
+
+uint8_t nvm_write_page(void)
+{
+    uint32_t start = timebase_now();
+    uint8_t err;
+
+    nvm_erase_page();
+    perf_counters.session.nvm_erase_ticks += timebase_ticks_since(start);
+    perf_counters.session.nvm_erases++;
+
+    start = timebase_now();
+    err = nvm_program_page();
+    perf_counters.session.nvm_program_ticks += timebase_ticks_since(start);
+    perf_counters.session.nvm_programs++;
+
+    return err;
+}
@@ -0,0 +1,458 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     ota.c
+ *  @brief    Firmware update over NFC with page level delta patches.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "crc32.h"
+#include "nvm_persist.h"
+#include "perf.h"
+#include "ota.h"
+#include "nfc_event.h"
+#include "mbx_pipe.h"
+
+
+//-------------------------------------------------------------
+// Definitions
+
+#define SLOT_ADDR(slot)     (OTA_STAGE_BASE + ((uint32_t) (slot) + 1) * OTA_PAGE_SIZE)
+#define NO_SLOT             0xFF
+
+// executed from RAM, see ota_activate()
+#define OTA_RAMFUNC         __attribute__((section(".ramfunc.ota"), noinline))
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+static ota_directory_t dir;             // assembled in RAM, written to NVM on commit
+static uint32_t page_buf[OTA_PAGE_WORDS];
+static uint32_t page_crc;
+static uint32_t page_dest;
+static uint8_t page_slot = NO_SLOT;
+static bool begun;
+
+
+//-------------------------------------------------------------
+
+static bool is_device_page(uint32_t address)
+{
+    return (address >= OTA_DEVICE_START) && (address < OTA_DEVICE_END);
+}
+
+// the device data is only written by provisioning, never by an update from the reader
+static bool is_valid_dest(uint32_t address, bool device)
+{
+    if ((address & (OTA_PAGE_SIZE - 1)) != 0)
+    {
+        return false;
+    }
+    if (device)
+    {
+        return is_device_page(address);
+    }
+    return !is_device_page(address) &&
+           (((address >= OTA_IMAGE_START) && (address < OTA_STAGE_BASE)) || (address == OTA_VERSION_PAGE));
+}
+
+static uint8_t program_page(uint32_t address, const uint32_t* data)
+{
+    volatile uint32_t* dst = (volatile uint32_t*) address;
+    uint8_t err;
+
+    nvm_config();
+    err = nvm_open_assembly_buffer(address);
+    if (err == 0)
+    {
+        for (uint8_t i = 0; i < OTA_PAGE_WORDS; i++)
+        {
+            dst[i] = data[i];
+        }
+        err = nvm_write_page();
+    }
+    nvm_config();
+
+    return err;
+}
+
+/*
+ * Copy the staged pages to their destination and reset.
+ * This runs from RAM: the pages being replaced may hold any NVM code, including this module.
+ * Consequently, only ROM functions may be called and interrupts stay disabled, since their
+ * handlers are located in NVM as well.
+ */
+static OTA_RAMFUNC void ota_activate(void)
+{
+    const ota_directory_t* d = (const ota_directory_t*) OTA_STAGE_BASE;
+    uint32_t buf[OTA_PAGE_WORDS];
+    uint16_t count;
+
+    __disable_irq();
+    nvm_config();
+
+    count = (d->count <= OTA_STAGE_SLOTS) ? d->count : 0;
+    for (uint16_t slot = 0; slot < count; slot++)
+    {
+        const volatile uint32_t* src = (const volatile uint32_t*) SLOT_ADDR(slot);
+        volatile uint32_t* dst = (volatile uint32_t*) ((uint32_t) d->dest_page[slot] * OTA_PAGE_SIZE);
+        bool same = true;
+
+        for (uint8_t i = 0; i < OTA_PAGE_WORDS; i++)
+        {
+            buf[i] = src[i];
+            if (dst[i] != buf[i])
+            {
+                same = false;
+            }
+        }
+        // pages already copied before a field loss are skipped
+        if (same)
+        {
+            continue;
+        }
+
+        nvm_open_assembly_buffer((uint32_t) dst);
+        for (uint8_t i = 0; i < OTA_PAGE_WORDS; i++)
+        {
+            dst[i] = buf[i];
+        }
+        nvm_erase_page();
+        nvm_program_page();
+        nvm_config();
+    }
+
+    // clear the pending mark
+    nvm_open_assembly_buffer(OTA_STAGE_BASE);
+    *((volatile uint32_t*) OTA_STAGE_BASE) = 0;
+    nvm_erase_page();
+    nvm_program_page();
+    nvm_config();
+
+    __DSB();
+    SCB->AIRCR = (0x5FAUL << SCB_AIRCR_VECTKEY_Pos) | SCB_AIRCR_SYSRESETREQ_Msk;
+    __DSB();
+    while (true)
+    {
+        ;
+    }
+}
+
+static ota_status_t store_page(uint8_t slot, uint32_t dest, const uint32_t* data, uint32_t crc)
+{
+    if ((program_page(SLOT_ADDR(slot), data) != 0) ||
+            (crc32((const void*) SLOT_ADDR(slot), OTA_PAGE_SIZE) != crc))
+    {
+        return ota_err_nvm;
+    }
+    dir.dest_page[slot] = (uint16_t) (dest / OTA_PAGE_SIZE);
+
+    return ota_ok;
+}
+
+ota_status_t ota_stage_begin(uint32_t image_crc, uint32_t count)
+{
+    if ((count == 0) || (count > OTA_STAGE_SLOTS))
+    {
+        return ota_err_range;
+    }
+
+    dir.magic = 0;
+    dir.image_crc = image_crc;
+    dir.count = (uint16_t) count;
+    dir.rfu = 0xFFFF;
+    for (uint8_t slot = 0; slot < OTA_STAGE_SLOTS; slot++)
+    {
+        dir.dest_page[slot] = 0;
+    }
+    page_slot = NO_SLOT;
+    begun = true;
+
+    return ota_ok;
+}
+
+ota_status_t ota_stage_device_page(uint8_t slot, uint32_t address, const uint32_t* data)
+{
+    uint32_t crc = crc32(data, OTA_PAGE_SIZE);
+
+    if (!begun)
+    {
+        return ota_err_state;
+    }
+    if ((slot >= dir.count) || !is_valid_dest(address, true))
+    {
+        return ota_err_range;
+    }
+
+    page_slot = NO_SLOT;
+    if (crc32((const void*) SLOT_ADDR(slot), OTA_PAGE_SIZE) == crc)
+    {
+        dir.dest_page[slot] = (uint16_t) (address / OTA_PAGE_SIZE);
+        return ota_staged;
+    }
+    dir.dest_page[slot] = 0;
+
+    return store_page(slot, address, data, crc);
+}
+
+static ota_status_t ota_page(const uint32_t* req)
+{
+    uint32_t slot = req[1];
+    uint32_t dest = req[2];
+    const uint32_t* old = (const uint32_t*) dest;
+
+    if (!begun)
+    {
+        return ota_err_state;
+    }
+    if ((slot >= dir.count) || !is_valid_dest(dest, false))
+    {
+        return ota_err_range;
+    }
+
+    page_slot = NO_SLOT;
+    if (crc32((const void*) SLOT_ADDR(slot), OTA_PAGE_SIZE) == req[3])
+    {
+        dir.dest_page[slot] = (uint16_t) (dest / OTA_PAGE_SIZE);
+        return ota_staged;
+    }
+
+    // runs are relative to the current content of the destination
+    for (uint8_t i = 0; i < OTA_PAGE_WORDS; i++)
+    {
+        page_buf[i] = old[i];
+    }
+    dir.dest_page[slot] = 0;
+    page_slot = (uint8_t) slot;
+    page_dest = dest;
+    page_crc = req[3];
+
+    return ota_ok;
+}
+
+static ota_status_t apply_runs(const uint32_t* payload, uint32_t words)
+{
+    uint32_t i = 0;
+
+    while (i < words)
+    {
+        uint32_t header = payload[i++];
+        uint32_t count = header & 0xFF;
+        uint32_t offset = (header >> 8) & 0xFF;
+
+        if ((offset + count) > OTA_PAGE_WORDS)
+        {
+            return ota_err_range;
+        }
+        if (header & OTA_RUN_FILL)
+        {
+            if (i >= words)
+            {
+                return ota_err_range;
+            }
+            while (count--)
+            {
+                page_buf[offset++] = payload[i];
+            }
+            i++;
+        }
+        else
+        {
+            if ((i + count) > words)
+            {
+                return ota_err_range;
+            }
+            while (count--)
+            {
+                page_buf[offset++] = payload[i++];
+            }
+        }
+    }
+    return ota_ok;
+}
+
+static ota_status_t ota_data(const uint32_t* req)
+{
+    uint32_t words = req[2] & 0xFFFF;
+    bool last = (req[2] >> 16) != 0;
+    ota_status_t status;
+
+    if (!begun || (page_slot == NO_SLOT) || (req[1] != page_slot))
+    {
+        return ota_err_state;
+    }
+    if (words > OTA_MAX_PAYLOAD)
+    {
+        return ota_err_range;
+    }
+    if (crc32(&req[4], words * 4) != req[3])
+    {
+        return ota_err_crc;
+    }
+
+    status = apply_runs(&req[4], words);
+    if ((status != ota_ok) || !last)
+    {
+        return status;
+    }
+
+    if (crc32(page_buf, OTA_PAGE_SIZE) != page_crc)
+    {
+        return ota_err_crc;
+    }
+    status = store_page(page_slot, page_dest, page_buf, page_crc);
+    if (status == ota_ok)
+    {
+        page_slot = NO_SLOT;
+    }
+
+    return status;
+}
+
+ota_status_t ota_stage_commit(void)
+{
+    uint32_t crc = CRC32_INIT;
+
+    if (!begun)
+    {
+        return ota_err_state;
+    }
+    for (uint16_t slot = 0; slot < dir.count; slot++)
+    {
+        if (dir.dest_page[slot] == 0)
+        {
+            return ota_err_state;
+        }
+    }
+
+    // CRC over the image as it will look after activation
+    for (uint32_t address = OTA_IMAGE_START; address < OTA_STAGE_BASE; address += OTA_PAGE_SIZE)
+    {
+        uint32_t src = address;
+
+        if (is_device_page(address))
+        {
+            continue;
+        }
+        for (uint16_t slot = 0; slot < dir.count; slot++)
+        {
+            if (((uint32_t) dir.dest_page[slot] * OTA_PAGE_SIZE) == address)
+            {
+                src = SLOT_ADDR(slot);
+            }
+        }
+        crc = crc32_update(crc, (const void*) src, OTA_PAGE_SIZE);
+    }
+    if (crc32_final(crc) != dir.image_crc)
+    {
+        return ota_err_image;
+    }
+
+    dir.magic = OTA_DIR_MAGIC;
+    if (program_page(OTA_STAGE_BASE, (const uint32_t*) &dir) != 0)
+    {
+        return ota_err_nvm;
+    }
+    begun = false;
+
+    return ota_ok;
+}
+
+ota_status_t ota_execute(uint32_t* req)
+{
+    ota_status_t status;
+
+    switch (req[0])
+    {
+        case OTA_CMD_BEGIN:
+            status = ota_stage_begin(req[1], req[2]);
+            break;
+
+        case OTA_CMD_PAGE:
+            status = ota_page(req);
+            break;
+
+        case OTA_CMD_DATA:
+            status = ota_data(req);
+            break;
+
+        case OTA_CMD_COMMIT:
+            status = ota_stage_commit();
+            break;
+
+        case OTA_CMD_ACTIVATE:
+            status = ota_err_state;
+            if (((const ota_directory_t*) OTA_STAGE_BASE)->magic == OTA_DIR_MAGIC)
+            {
+                ota_activate();
+            }
+            break;
+
+        default:
+            status = ota_err_cmd;
+            break;
+    }
+
+    if ((status != ota_ok) && (status != ota_staged))
+    {
+        perf_counters.session.request_errors++;
+        if (status == ota_err_crc)
+        {
+            perf_counters.session.crc_errors++;
+        }
+    }
+
+    req[0] = status;
+    return status;
+}
+
+uint32_t ota_handler(Mailbox_t* mbx)
+{
+    uint32_t* req = &mbx->content[OTA_MBX_OFFSET];
+    uint32_t cmd = req[0];
+    ota_status_t status;
+
+    perf_counters.session.requests++;
+    if (pipe_busy())
+    {
+        // the bottom half works on the same staging state
+        perf_counters.session.request_errors++;
+        status = ota_err_busy;
+        req[0] = status;
+    }
+    else
+    {
+        status = ota_execute(req);
+    }
+
+    nfc_event_post(nfc_event_ota, (uint16_t) (((cmd & 0xFFU) << 8) | (uint32_t) status));
+    return status;
+}
+
+void ota_resume(void)
+{
+    nvm_config();
+    if (((const ota_directory_t*) OTA_STAGE_BASE)->magic == OTA_DIR_MAGIC)
+    {
+        ota_activate();
+    }
+}
@@ -0,0 +1,85 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     perf.c
+ *  @brief    Firmware performance counters of the session and of the device lifetime.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "nvm_persist.h"
+#include "perf.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+perf_counters_t perf_counters;
+
+static perf_lifetime_t stored;
+
+
+//-------------------------------------------------------------
+
+static void update_lifetime(perf_lifetime_t* l)
+{
+    const perf_session_t* s = &perf_counters.session;
+
+    l->sessions = stored.sessions + 1;
+    l->requests = stored.requests + s->requests;
+    l->request_errors = stored.request_errors + s->request_errors;
+    l->auth_ok = stored.auth_ok + s->auth_ok;
+    l->auth_failures = stored.auth_failures + s->auth_failures;
+    l->nvm_erases = stored.nvm_erases + s->nvm_erases;
+    l->motor_pulses = stored.motor_pulses + s->motor_pulses;
+    l->rfu = 0;
+}
+
+void perf_init(void)
+{
+    const volatile uint32_t* src = (const volatile uint32_t*) PERF_LIFETIME_ADDR;
+    uint32_t* dst = (uint32_t*) &stored;
+
+    nvm_config();
+    for (uint8_t i = 0; i < (sizeof(perf_lifetime_t) / sizeof(uint32_t)); i++)
+    {
+        // erased words count from 0
+        dst[i] = (src[i] == UINT32_MAX) ? 0 : src[i];
+    }
+    update_lifetime(&perf_counters.lifetime);
+}
+
+void perf_stage(void)
+{
+    volatile uint32_t* dst = (volatile uint32_t*) PERF_LIFETIME_ADDR;
+    const uint32_t* src = (const uint32_t*) &perf_counters.lifetime;
+
+    update_lifetime(&perf_counters.lifetime);
+    for (uint8_t i = 0; i < (sizeof(perf_lifetime_t) / sizeof(uint32_t)); i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+void perf_notify_tx(uint16_t data_point_id)
+{
+    (void) data_point_id;
+    update_lifetime(&perf_counters.lifetime);
+}
@@ -0,0 +1,122 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     power.c
+ *  @brief    Reference counted power domains with on-time accounting.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// Smack NVM lib
+#include "shc_lib.h"
+
+// smack_sl project
+#include "timebase.h"
+#include "power.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+typedef struct
+{
+    void (*on)(void);
+    void (*off)(void);
+} power_ops_t;
+
+static void uart_off(void)
+{
+    set_uart_control(false, false, false);
+}
+
+static const power_ops_t power_ops[power_domain_count] =
+{
+    [power_domain_shc]   = { shc_init, shc_close },
+    [power_domain_uart]  = { NULL,     uart_off },
+};
+
+power_stats_t power_stats;
+
+static uint32_t on_since[power_domain_count];
+
+
+//-------------------------------------------------------------
+
+void power_acquire(power_domain_t domain)
+{
+    uint32_t primask = __get_PRIMASK();
+    bool first;
+
+    __disable_irq();
+    first = (power_stats.users[domain]++ == 0);
+    if (first)
+    {
+        on_since[domain] = timebase_now();
+    }
+    __set_PRIMASK(primask);
+
+    if (first && (power_ops[domain].on != NULL))
+    {
+        power_ops[domain].on();
+    }
+}
+
+void power_release(power_domain_t domain)
+{
+    uint32_t primask = __get_PRIMASK();
+    bool last = false;
+
+    __disable_irq();
+    if (power_stats.users[domain] != 0)
+    {
+        last = (--power_stats.users[domain] == 0);
+        if (last)
+        {
+            power_stats.on_ticks[domain] += timebase_ticks_since(on_since[domain]);
+        }
+    }
+    __set_PRIMASK(primask);
+
+    if (last && (power_ops[domain].off != NULL))
+    {
+        power_ops[domain].off();
+    }
+}
+
+void power_notify_tx(uint16_t data_point_id)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    (void) data_point_id;
+
+    // account the running periods up to now, so the values read are current
+    __disable_irq();
+    for (uint8_t i = 0; i < (uint8_t) power_domain_count; i++)
+    {
+        if (power_stats.users[i] != 0)
+        {
+            uint32_t now = timebase_now();
+
+            power_stats.on_ticks[i] += now - on_since[i];
+            on_since[i] = now;
+        }
+    }
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,167 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     profiler.c
+ *  @brief    Statistical profiler sampling the interrupted PC on the SysTick.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "profiler.h"
+
+#ifdef PROFILER
+
+//-------------------------------------------------------------
+// globals/statics
+
+#define ROM_END         0x00004000UL
+#define FRAME_SEARCH    8           // words pushed by the ROM dispatcher searched for EXC_RETURN
+#define XPSR_T          (1UL << 24)
+
+extern uint32_t __data2_start__;    // RAM code (Linker_config.ld)
+extern uint32_t __data2_end__;
+
+static uint16_t histogram[PROFILER_BUCKETS + profiler_bin_count];
+
+profiler_info_t profiler_info =
+{
+    .histogram = (uint32_t) histogram,
+    .start = PROFILER_START,
+    .buckets = PROFILER_BUCKETS,
+    .shift = PROFILER_BUCKET_SHIFT,
+};
+
+uint32_t profiler_period;
+
+void profiler_sample(const uint32_t* sp);
+
+
+//-------------------------------------------------------------
+
+/* The ROM dispatcher calls the handler with its own registers on the stack, profiler_sample() locates
+   the exception frame from there. The main loop and all handlers run on the MSP. */
+__attribute__((naked)) void profiler_systick_handler(void)
+{
+    __asm volatile
+    (
+        "mov    r0, sp              \n"
+        "ldr    r1, =profiler_sample\n"
+        "bx     r1                  \n"
+        ".ltorg                     \n"
+    );
+}
+
+static bool is_exc_return(uint32_t value)
+{
+    return (value == 0xFFFFFFF1UL) || (value == 0xFFFFFFF9UL) || (value == 0xFFFFFFFDUL);
+}
+
+// the interrupted PC, 0 if no plausible exception frame is found
+static uint32_t get_pc(const uint32_t* sp)
+{
+    const uint32_t* frame = NULL;
+    uint32_t pc;
+
+    // the dispatcher pushes the EXC_RETURN of its entry last, the exception frame follows
+    for (uint32_t i = 0; i < FRAME_SEARCH; i++)
+    {
+        if (is_exc_return(sp[i]))
+        {
+            frame = ((sp[i] & 0x4UL) != 0) ? (const uint32_t*) __get_PSP() : &sp[i + 1];
+            break;
+        }
+    }
+    if ((frame == NULL) || ((frame[7] & XPSR_T) == 0))
+    {
+        return 0;
+    }
+
+    pc = frame[6];
+    if ((pc & 0x1UL) != 0)
+    {
+        return 0;
+    }
+    return pc;
+}
+
+void profiler_sample(const uint32_t* sp)
+{
+    uint32_t pc = get_pc(sp);
+    uint32_t index;
+
+    if ((pc >= PROFILER_START) && (pc < PROFILER_END))
+    {
+        index = (pc - PROFILER_START) >> PROFILER_BUCKET_SHIFT;
+    }
+    else if ((pc != 0) && (pc < ROM_END))
+    {
+        index = PROFILER_BUCKETS + profiler_bin_rom;
+    }
+    else if ((pc >= (uint32_t) &__data2_start__) && (pc < (uint32_t) &__data2_end__))
+    {
+        index = PROFILER_BUCKETS + profiler_bin_ram;
+    }
+    else
+    {
+        index = PROFILER_BUCKETS + profiler_bin_rejected;
+    }
+
+    if (histogram[index] != UINT16_MAX)
+    {
+        histogram[index]++;
+    }
+    profiler_info.samples++;
+}
+
+void profiler_start(uint32_t period)
+{
+    SysTick->CTRL = 0;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+    if (period == 0)
+    {
+        profiler_info.period = 0;
+        return;
+    }
+    if (period < PROFILER_MIN_PERIOD)
+    {
+        period = PROFILER_MIN_PERIOD;
+    }
+    else if (period > PROFILER_MAX_PERIOD)
+    {
+        period = PROFILER_MAX_PERIOD;
+    }
+    profiler_info.period = period;
+
+    memset(histogram, 0, sizeof(histogram));
+    profiler_info.samples = 0;
+    SysTick->LOAD = period - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+void profiler_notify_rx(uint16_t data_point_id)
+{
+    (void) data_point_id;
+    profiler_start(profiler_period);
+}
+
+#endif /* PROFILER */
@@ -0,0 +1,331 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     provision.c
+ *  @brief    Device data in APARAM and its provisioning over the UART on the production line.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+#include "nvm_params.h"
+
+// smack_sl project
+#include "smack_sl.h"
+#include "crc32.h"
+#include "timebase.h"
+#include "version.h"
+#include "power.h"
+#include "uart_regs.h"
+#include "ota.h"
+#include "provision.h"
+#include "ring.h"
+
+
+//-------------------------------------------------------------
+
+uint32_t provision_serial(void)
+{
+    uint32_t serial = PROVISION_PUBLIC->serial;
+
+    return (serial != 0xFFFFFFFFUL) ? serial : SERIAL_NUMBER;
+}
+
+bool provision_read_protected(uint32_t address)
+{
+    uint32_t page;
+    uint32_t entry;
+
+    if ((address < NVM_BASE) || (address >= NVM_STOP))
+    {
+        return false;
+    }
+    page = (address - NVM_BASE) / OTA_PAGE_SIZE;
+    entry = (aparams.nvm_prot_sect[page / 4] >> (2 * (page % 4))) & 0x3U;
+
+    return (entry & PROVISION_PROT_WRITE) == 0;
+}
+
+#ifdef UART_PROVISION
+
+//-------------------------------------------------------------
+// globals/statics
+
+#define RX_LEVEL            2               //!< RX interrupt when the FIFO is 1/2 full
+#define HEADER              3               //!< SOF, command, length
+#define MAX_PAYLOAD         (4 + OTA_PAGE_SIZE)     //!< index and padding, page content
+#define FRAME_GAP_TICKS     TIMEBASE_TICKS_PER_MS   //!< a pause this long starts a new frame
+#define RX_GAP              0x0100U         //!< RX item flag: a pause or lost bytes before this byte
+#define RX_SIZE             256             //!< the host sends one frame and waits for the reply
+
+// handler to main loop
+static RING_T(uint16_t, RX_SIZE) rx;
+static uint32_t last_byte;
+static bool rx_lost;
+
+static uint8_t frame[HEADER + MAX_PAYLOAD + 4];
+static uint16_t received;
+static uint8_t next_page;
+static uint32_t bundle_crc;
+static uint32_t baudrate;
+
+
+//-------------------------------------------------------------
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void put_u32(uint8_t* p, uint32_t value)
+{
+    p[0] = (uint8_t) value;
+    p[1] = (uint8_t) (value >> 8);
+    p[2] = (uint8_t) (value >> 16);
+    p[3] = (uint8_t) (value >> 24);
+}
+
+static void send_byte(uint8_t value)
+{
+    while (UART_FR & UART_FR_TXFF)
+    {
+        ;
+    }
+    UART_DR = value;
+}
+
+static void send_reply(uint8_t cmd, const uint8_t* payload, uint8_t length)
+{
+    uint8_t crc[4];
+    uint32_t value = crc32_update(CRC32_INIT, &cmd, 1);
+
+    value = crc32_update(value, &length, 1);
+    put_u32(crc, crc32_final(crc32_update(value, payload, length)));
+
+    send_byte(PROVISION_SOF);
+    send_byte(cmd);
+    send_byte(length);
+    for (uint8_t i = 0; i < length; i++)
+    {
+        send_byte(payload[i]);
+    }
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        send_byte(crc[i]);
+    }
+}
+
+static bool is_provisioned(void)
+{
+    return PROVISION_PUBLIC->serial != 0xFFFFFFFFUL;
+}
+
+static provision_status_t stage_page(const uint8_t* payload, uint8_t* ota_status)
+{
+    uint32_t page[OTA_PAGE_WORDS];
+    uint8_t index = payload[0];
+    ota_status_t status;
+
+    // page 0 restarts the bundle
+    if ((index != next_page) && (index != 0))
+    {
+        return provision_err_order;
+    }
+    if (index == 0)
+    {
+        status = ota_stage_begin(version.crc, PROVISION_PAGES);
+        if (status != ota_ok)
+        {
+            *ota_status = (uint8_t) status;
+            return provision_err_stage;
+        }
+        bundle_crc = CRC32_INIT;
+    }
+
+    memcpy(page, &payload[4], OTA_PAGE_SIZE);
+    status = ota_stage_device_page(index, PROVISION_START + (uint32_t) index * OTA_PAGE_SIZE, page);
+    *ota_status = (uint8_t) status;
+    if ((status != ota_ok) && (status != ota_staged))
+    {
+        return provision_err_stage;
+    }
+    bundle_crc = crc32_update(bundle_crc, page, OTA_PAGE_SIZE);
+    next_page++;
+
+    return provision_ok;
+}
+
+static provision_status_t commit(const uint8_t* payload, uint8_t* ota_status)
+{
+    ota_status_t status;
+
+    if (next_page != PROVISION_PAGES)
+    {
+        return provision_err_order;
+    }
+    if (crc32_final(bundle_crc) != get_u32(payload))
+    {
+        next_page = 0;
+        return provision_err_bundle;
+    }
+    status = ota_stage_commit();
+    *ota_status = (uint8_t) status;
+    next_page = 0;
+
+    return (status == ota_ok) ? provision_ok : provision_err_stage;
+}
+
+static void execute(void)
+{
+    uint8_t cmd = frame[1];
+    uint8_t length = frame[2];
+    const uint8_t* payload = &frame[HEADER];
+    uint8_t reply[4 + sizeof(provision_info_t)] = { 0 };
+    uint8_t reply_length = 2;
+    provision_status_t status;
+
+    if (crc32(&frame[1], 2 + (uint32_t) length) != get_u32(&payload[length]))
+    {
+        status = provision_err_crc;
+    }
+    else if (cmd == PROVISION_CMD_INFO)
+    {
+        status = (length == 0) ? provision_ok : provision_err_length;
+        put_u32(&reply[4], version.crc);
+        put_u32(&reply[8], PROVISION_PUBLIC->serial);
+        put_u32(&reply[12], baudrate);
+        reply_length = sizeof(reply);
+    }
+    else if ((cmd != PROVISION_CMD_PAGE) && (cmd != PROVISION_CMD_COMMIT))
+    {
+        status = provision_err_cmd;
+    }
+    else if (is_provisioned())
+    {
+        status = provision_err_locked;
+    }
+    else if (cmd == PROVISION_CMD_PAGE)
+    {
+        status = (length == MAX_PAYLOAD) ? stage_page(payload, &reply[1]) : provision_err_length;
+    }
+    else
+    {
+        status = (length == 4) ? commit(payload, &reply[1]) : provision_err_length;
+    }
+
+    reply[0] = (uint8_t) status;
+    send_reply(cmd, reply, reply_length);
+
+    if ((cmd == PROVISION_CMD_COMMIT) && (status == provision_ok))
+    {
+        // the reply has to leave the device before the activation resets it
+        while (UART_FR & UART_FR_BUSY)
+        {
+            ;
+        }
+        ota_resume();
+    }
+    else if ((cmd == PROVISION_CMD_INFO) && (status == provision_ok) && is_provisioned())
+    {
+        // the host has read back the serial number, provisioning is over
+        while (UART_FR & UART_FR_BUSY)
+        {
+            ;
+        }
+        UART_IMSC = 0;
+        power_release(power_domain_uart);
+    }
+}
+
+static void receive(uint16_t item)
+{
+    uint8_t value = (uint8_t) item;
+
+    if ((item & RX_GAP) != 0)
+    {
+        received = 0;
+    }
+    if ((received == 0) && (value != PROVISION_SOF))
+    {
+        return;
+    }
+    frame[received++] = value;
+
+    if (received == HEADER)
+    {
+        if (frame[2] > MAX_PAYLOAD)
+        {
+            received = 0;
+        }
+    }
+    else if ((received > HEADER) && (received == (HEADER + frame[2] + 4)))
+    {
+        received = 0;
+        execute();
+    }
+}
+
+void provision_init(void)
+{
+    if (aparams.disable_default_uart != DISABLE_DEFAULT_UART)
+    {
+        return;
+    }
+    baudrate = aparams.default_uart_baudrate & 0x00FFFFFFUL;
+    if ((baudrate == 0) || (baudrate == 0x00FFFFFFUL))
+    {
+        baudrate = PROVISION_BAUDRATE;
+    }
+
+    power_acquire(power_domain_uart);
+    set_uart_baudrate(baudrate);
+    init_uart(false, even, false, true, uart_bits_8, false);
+    set_uart_control(true, true, true);
+    configure_uart_irq(PROVISION_UART_IRQ, RX_LEVEL, 0, true, false);
+    // bytes below the FIFO level are picked up by the timeout interrupt
+    UART_IMSC |= UART_IMSC_RTIM;
+}
+
+void provision_poll(void)
+{
+    uint16_t item;
+
+    while (RING_POP(rx, &item))
+    {
+        receive(item);
+    }
+}
+
+void provision_uart_handler(void)
+{
+    while ((UART_FR & UART_FR_RXFE) == 0)
+    {
+        uint32_t now = timebase_now();
+        uint16_t item = (uint16_t) (UART_DR & 0xFFU);
+
+        if (rx_lost || ((now - last_byte) > FRAME_GAP_TICKS))
+        {
+            item |= RX_GAP;
+        }
+        last_byte = now;
+        // a dropped byte corrupts the frame, the parser restarts at the next byte
+        rx_lost = !RING_PUSH(rx, item);
+    }
+}
+
+#endif /* UART_PROVISION */
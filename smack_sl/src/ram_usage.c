@@ -0,0 +1,62 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     ram_usage.c
+ *  @brief    Stack high-water mark by painting the unused RAM.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// smack_sl project
+#include "ram_usage.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+extern uint32_t __HeapLimit;
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+
+ram_usage_t ram_usage;
+
+
+//-------------------------------------------------------------
+
+void ram_usage_update(void)
+{
+    const uint32_t* p = &__HeapLimit;
+    const uint32_t* sp = (const uint32_t*) __get_MSP();
+
+    // the painted area ends below the stack pointer, the search stops there at the latest
+    while ((p < sp) && (*p == RAM_USAGE_PATTERN))
+    {
+        p++;
+    }
+
+    ram_usage.stack_top = (uint32_t) &__StackTop;
+    ram_usage.static_end = (uint32_t) &__HeapLimit;
+    ram_usage.high_water = (uint32_t) p;
+    ram_usage.stack_used = (uint16_t) (ram_usage.stack_top - ram_usage.high_water);
+    ram_usage.stack_size = (uint16_t) ((uint32_t) &__StackTop - (uint32_t) &__StackLimit);
+    ram_usage.headroom = (uint16_t) (ram_usage.high_water - ram_usage.static_end);
+}
+
+void ram_usage_notify_tx(uint16_t data_point_id)
+{
+    (void) data_point_id;
+    ram_usage_update();
+}
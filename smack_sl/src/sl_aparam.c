@@ -24,9 +24,24 @@
 
 #include "cmsis_compiler.h"
 #include "aparam.h"
+#include "handlers.h"
+#include "nvm_params.h"
 #include "smack_sl.h"
+#include "ndef_tag.h"
+#include "burst.h"
+#include "ota.h"
+#include "mbx_pipe.h"
+#include "dp_crypt.h"
+#include "dp_chunk.h"
 #include "aes_lib.h"
 #include "smack_exchange.h"
+#include "smack_dataexchange.h"
+#include "profiler.h"
+#include "log.h"
+#include "provision.h"
+#include "spi.h"
+#include "irq_map.h"
+#include "irq_bench.h"
 
 /**
  * @defgroup group_aparam_variables APARAM variables
@@ -59,13 +74,13 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
 
     .app_prog =                                                /**< [0x447:0x408] (32 * 16) absolute address App function 0 through 15 */
     {
-        (param_func_ptr_t)smack_exchange_handler,
-        0xffffffff,
-        0xffffffff,
-        0xffffffff,
-        0xffffffff,
-        0xffffffff,
-        0xffffffff,
+        (param_func_ptr_t)data_exchange_handler,               /**  data exchange, initialized on first use (smack_dataexchange.c)    */
+        (param_func_ptr_t)burst_handler,                       /**  BURST_APP_FUNCTION                                                */
+        (param_func_ptr_t)ota_handler,                         /**  OTA_APP_FUNCTION                                                  */
+        (param_func_ptr_t)pipe_handler,                        /**  PIPE_APP_FUNCTION                                                 */
+        (param_func_ptr_t)data_exchange_crypt_handler,         /**  DP_CRYPT_APP_FUNCTION                                             */
+        (param_func_ptr_t)data_exchange_chunk_handler,         /**  DP_CHUNK_APP_FUNCTION                                             */
+        (param_func_ptr_t)auth_handler,                        /**  AUTH_APP_FUNCTION                                                 */
         0xffffffff,
         0xffffffff,
         0xffffffff,
@@ -81,13 +96,21 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
     0xffffffff,
 
     .default_uart_baudrate =                                   /**< [0x44f:0x44c] (24) default UART baudrate in baud                 */
+#ifdef UART_PROVISION
+    PROVISION_BAUDRATE,                                        /**  baudrate of the provisioning protocol                            */
+#else
     0xffffffff,
+#endif
 
     .kill_debugger =                                           /**< [0x453:0x450] (32) 0x5deb0ff5 will block debugger access         */
     0xffffffff,
 
     .disable_default_uart =                                    /**< [0x457:0x454] (32) 0x11223344 disable UART per ROM code          */
+#ifdef UART_PROVISION
+    DISABLE_DEFAULT_UART,                                      /**  UART used by the provisioning protocol                           */
+#else
     0xffffffff,
+#endif
 
     .message_disable =                                         /**< [0x0x45b:0x458] (32) 0x11E550FF ignore external send message req */
     0xffffffff,
@@ -149,28 +172,28 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
     0xffffffff,
 
     .evbus_handler7_source =                                   /**< [0x4c7:0x4c4] (32)  0x00 + custom source of evbus7 irq           */
-    0xffffffff,
+    IRQ_MAP_EVBUS7,
 
     .evbus_handler8_source =                                   /**< [0x4cb:0x4c8] (32)  0x00 + custom source of evbus8 irq           */
-    0xffffffff,
+    IRQ_MAP_EVBUS8,
 
     .hp_irq9_cfg =                                             /**< [0x4cf:0x4cc] (32)  0x00 + irq source of matrix irq              */
-    0xffffffff,
+    IRQ_MAP_HP9,
 
     .hp_irq10_cfg =                                            /**< [0x4d3:0x4d0] (32)  0x00 + irq source of matrix irq              */
-    0xffffffff,
+    IRQ_MAP_HP10,
 
     .hp_irq11_cfg =                                            /**< [0x4d7:0x4d4] (32)  0x00 + irq source of matrix irq              */
-    0xffffffff,
+    IRQ_MAP_HP11,
 
     .hp_irq12_cfg =                                            /**< [0x4db:0x4d8] (32)  0x00 + irq source of matrix irq              */
-    0xffffffff,
+    IRQ_MAP_HP12,
 
     .hp_irq13_cfg =                                            /**< [0x4df:0x4dc] (32)  0x00 + irq source of matrix irq              */
-    0xffffffff,
+    IRQ_MAP_HP13,
 
     .hp_irq14_cfg =                                            /**< [0x4e3:0x4e0] (32)  0x00 + irq source of matrix irq              */
-    0xffffffff,
+    IRQ_MAP_HP14,
 
     .hp_irq9_col_cfg =                                         /**< [0x4e7:0x4e4] (32)  0x00 + column config register                */
     0xffffffff,
@@ -217,16 +240,30 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
     0xffffffff,
 
     .timer4_hand_addr =                                        /**< [0x51f:0x51c] (32)  absolute address of custom handler           */
-    0xffffffff,
+    (param_func_ptr_t)data_exchange_bottom_half,
 
     .timer5_hand_addr =                                        /**< [0x523:0x520] (32)  absolute address of custom handler           */
+#ifdef IRQ_BENCHMARK
+    (param_func_ptr_t)irq_bench_handler,
+#else
     0xffffffff,
+#endif
 
     .uart_hand_addr =                                          /**< [0x527:0x524] (32)  absolute address of custom handler           */
+#if defined(UART_LOG)
+    (param_func_ptr_t)log_uart_handler,
+#elif defined(UART_PROVISION)
+    (param_func_ptr_t)provision_uart_handler,
+#else
     0xffffffff,
+#endif
 
     .ssp_hand_addr =                                           /**< [0x52b:0x528] (32)  absolute address of custom handler           */
+#ifdef SPI_DRIVER
+    (param_func_ptr_t)spi_ssp_handler,
+#else
     0xffffffff,
+#endif
 
     .i2c_hand_addr =                                           /**< [0x52f:0x52c] (32)  absolute address of custom handler           */
     0xffffffff,
@@ -262,7 +299,11 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
     (param_func_ptr_t)hardfault_handler,
 
     .systick_hand_addr =                                       /**< [0x55b:0x558] (32)  absolute address of custom handler           */
+#ifdef PROFILER
+    (param_func_ptr_t)profiler_systick_handler,
+#else
     (param_func_ptr_t)example_handler,                         /**  example for a customer owned interrupt service routine in NVM    */
+#endif
 
     .wdt_hand_addr =                                           /**< [0x55f:0x55c] (32)  absolute address of custom handler           */
     0xffffffff,
@@ -278,13 +319,13 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
         0xff, 0xff, 0xff, 0xff
     },
 
-    .tag_type_2_ptr =                                          /**< [0x57f:0x57c] (32)  address of NFC tag information in NVM        */
-    (param_ptr_t)smack_sl_tag,
+    .tag_type_2_ptr =                                          /**< [0x57f:0x57c] (32)  address of NFC tag information in RAM        */
+    (param_ptr_t)&ndef_tag,                                    /**  status tag, filled from a template at startup (ndef_tag.h)       */
 
 
     .nvm_prot_sect =                                           /**< [0x5f7:0x580] (120*8) R/W protection of NVM pages 0..119         */
-    {
-        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    {                                                          /**  2 bits per 128 byte page, 01: read protected (provision.h)       */
+        0xff, 0xff, 0xff, 0xf5, 0xff, 0xff, 0xff, 0xff,  /* 0x10600: secret[] */
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
@@ -297,8 +338,8 @@ Aparams_t const aparams __attribute__ ((section (".nvm.APARAMS"))) =
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+        0xff, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,  /* 0x1D200: OTA slots */
+        0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xd5  /* ... 0x1EF00: persistent page */
     },
 
     .rfu3 =                                                    /**< [0x5ff:0x5f8] (64)  reserved for future usage                    */
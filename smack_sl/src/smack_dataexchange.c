@@ -42,6 +42,26 @@
 // smack_sl project
 #include "smack_sl.h"
 #include "smack_dataexchange.h"
+#include "vclamp_tuner.h"
+#include "field_predictor.h"
+#include "charge_progress.h"
+#include "image_check.h"
+#include "timebase.h"
+#include "boot.h"
+#include "power.h"
+#include "profiler.h"
+#include "trace.h"
+#include "perf.h"
+#include "ram_usage.h"
+#include "spi.h"
+#include "ring.h"
+#include "irq_bench.h"
+#include "nfc_event.h"
+#include "mbx_pipe.h"
+#include "aes_key.h"
+#include "dp_crypt.h"
+#include "dp_chunk.h"
+#include "provision.h"
 
 
 
@@ -55,6 +75,16 @@ static uint64_t scratch64;
 static uint8_t scratch8;
 static uint8_t scratch_str[100];
 static uint8_t count8;
+static uint32_t sealed32;
+static uint8_t sealed_str[33];
+static uint8_t chunk_scratch[256];
+static uint32_t chunk_scratch_used;
+static bool exchange_ready;
+
+// deferred notifications, NFC handler to bottom half
+#define DEFER_IRQ           Event_Bus8_IRQn     //!< pended by software, route, priority and enable in irq_map.c
+
+static EVENT_QUEUE_T(DATA_EXCHANGE_DEFER_SIZE) deferred;
 
 // measured values
 static int16_t temperature;
@@ -84,6 +114,33 @@ static const data_point_entry_t data_point_list[] =
     {0x0081,            data_point_int16,                                sizeof(uint16_t),  &humidity,          NULL, NULL},
     {0x0082,            data_point_int16,                                sizeof(uint16_t),  &pressure,          NULL, NULL},
     {0x0083,            data_point_int32,                                sizeof(uint32_t),  &m_reserved,        NULL, NULL},
+    // diagnostics
+    {0x0090,            data_point_array,                                sizeof(vclamp_tuner_stats_t), &vclamp_tuner_stats, NULL, NULL},
+    {0x0091,            data_point_array,                                sizeof(field_predictor_stats_t), &field_predictor_stats, NULL, NULL},
+    {0x0092,            data_point_array,                                sizeof(charge_progress_t), &charge_progress, NULL, charge_progress_notify_tx},
+    {0x0093,            data_point_array,                                sizeof(image_check_stats_t), &image_check_stats, NULL, NULL},
+    {0x0094,            data_point_array,                                sizeof(boot_profile_t), &boot_profile, NULL, NULL},
+    {0x0095,            data_point_array,                                sizeof(motor_stats_t), &motor_stats, NULL, NULL},
+    {0x0096,            data_point_array,                                sizeof(power_stats_t), &power_stats, NULL, power_notify_tx},
+#ifdef PROFILER
+    {0x0097,            data_point_array,                                sizeof(profiler_info_t), &profiler_info, NULL, NULL},
+    {0x0098,            data_point_uint32 | data_point_write,            sizeof(uint32_t),  &profiler_period,   data_exchange_defer_rx, NULL},
+#endif
+    {0x0099,            data_point_uint32 | data_point_write,            sizeof(uint32_t),  &trace_cursor,      NULL, NULL},
+    {0x009A,            data_point_array,                                sizeof(trace_chunk_t), &trace_chunk, NULL, trace_notify_tx},
+    {0x009B,            data_point_array,                                sizeof(perf_counters_t), &perf_counters, NULL, perf_notify_tx},
+    {0x009C,            data_point_array,                                sizeof(ram_usage_t), &ram_usage, NULL, ram_usage_notify_tx},
+#ifdef SPI_BENCHMARK
+    {0x009D,            data_point_array,                                sizeof(spi_bench_t), &spi_bench, NULL, NULL},
+#endif
+#ifdef IRQ_BENCHMARK
+    {0x009E,            data_point_array,                                sizeof(irq_bench_t), &irq_bench, NULL, NULL},
+#endif
+    {0x009F,            data_point_array,                                sizeof(pipe_stats_t), &pipe_stats, NULL, NULL},
+    {0x00A0,            data_point_array,                                sizeof(dp_crypt_stats_t), &dp_crypt_stats, NULL, dp_crypt_notify_tx},
+#ifdef DP_CRYPT_BENCHMARK
+    {0x00A1,            data_point_array,                                sizeof(dp_crypt_bench_t), &dp_crypt_bench, NULL, NULL},
+#endif
     {0x1800,            data_point_int64  | data_point_write,            sizeof(int64_t),   &scratch64,         NULL, NULL},
     {0x1801,            data_point_string | data_point_write,            sizeof(scratch_str) - 1, &scratch_str, NULL, NULL},
     {0x1900,            data_point_uint8  | data_point_write,            sizeof(uint8_t),   &scratch8,          NULL, NULL},
@@ -92,6 +149,33 @@ static const data_point_entry_t data_point_list[] =
 };
 static const uint16_t data_point_count = (sizeof(data_point_list) / sizeof(data_point_list[0]));
 
+// data points exchanged only encrypted (dp_crypt.h), the data exchange library does not see them
+static const data_point_entry_t sealed_point_list[] =
+{
+    // id               type                                                                 length             element             notify
+    {0x1A00,            data_point_uint32 | data_point_encrypt | data_point_write,           sizeof(uint32_t),  &sealed32,          NULL, NULL},
+    {0x1A01,            data_point_string | data_point_encrypt | data_point_write,           sizeof(sealed_str) - 1, &sealed_str, NULL, NULL},
+};
+static const uint16_t sealed_point_count = (sizeof(sealed_point_list) / sizeof(sealed_point_list[0]));
+
+// objects larger than a data point, transferred in chunks (dp_chunk.h)
+static const dp_chunk_object_t chunk_object_list[] =
+{
+    // id               flags               size                        buffer                          used                    notify
+    {0x2000,            0,                  sizeof(provision_public_t), (void*) PROVISION_PUBLIC,       NULL,                   NULL, NULL},
+    {0x2001,            DP_CHUNK_WRITE,     sizeof(chunk_scratch),      chunk_scratch,                  &chunk_scratch_used,    NULL, NULL},
+};
+static const uint16_t chunk_object_count = (sizeof(chunk_object_list) / sizeof(chunk_object_list[0]));
+
+// notify_rx functions of the data points with data_exchange_defer_rx() in data_point_list[]
+static const deferred_rx_entry_t deferred_rx_list[] =
+{
+#ifdef PROFILER
+    {0x0098,            profiler_notify_rx},
+#endif
+    {0xFFFF,            NULL}
+};
+
 
 //-------------------------------------------------------------
 
@@ -108,8 +192,102 @@ void vars_init(void)
           ((uint64_t)dparams.chip_uid.uid[6] <<  0);
 
     // Setup NFC data point exchange
-    // The smack_exchange_handler() callback must be configured in the APARAM block
+    // smack_exchange_handler() is called through data_exchange_handler(), which is configured in the APARAM block
     smack_exchange_init(data_point_list, data_point_count);
 
+    // the session of the encrypted data points draws a random number, which loads another key
+    dp_crypt_init(sealed_point_list, sealed_point_count,
+                  (PROVISION_PUBLIC->serial != 0xFFFFFFFFUL) ? (const aes_block_t*) PROVISION_SECRET->key : &aes_default_key);
+
     smack_exchange_key_set(&aes_default_key);
+    aes_key_loaded(&aes_default_key);
+}
+
+void data_exchange_defer_rx(uint16_t data_point_id)
+{
+    // a full queue is counted in deferred.lost, the bottom half still runs for the queued ones
+    (void) EVENT_POST(deferred, data_point_id, 0);
+    data_exchange_schedule();
+}
+
+void data_exchange_schedule(void)
+{
+    NVIC_SetPendingIRQ(DEFER_IRQ);
+}
+
+uint16_t data_exchange_deferred_lost(void)
+{
+    return deferred.lost;
+}
+
+void data_exchange_bottom_half(void)
+{
+    ring_event_t e;
+
+    while (EVENT_GET(deferred, &e))
+    {
+        for (const deferred_rx_entry_t* d = deferred_rx_list; d->notify_rx != NULL; d++)
+        {
+            if (d->data_point_id == e.id)
+            {
+                d->notify_rx(e.id);
+                break;
+            }
+        }
+    }
+
+    pipe_run();
+}
+
+// set up the data exchange on the first request instead of at startup
+static void exchange_init(void)
+{
+    uint32_t start;
+
+    if (!exchange_ready)
+    {
+        start = timebase_now();
+        boot_profile.first_exchange = boot_profile_uptime();
+        vars_init();
+        exchange_ready = true;
+        boot_profile_record(boot_step_exchange, start);
+        trace_event(trace_exchange, 0);
+    }
+}
+
+// APARAM app function 0
+void data_exchange_handler(void)
+{
+    perf_counters.session.requests++;
+    exchange_init();
+    smack_exchange_handler();
+    nfc_event_post(nfc_event_exchange, 0);
+}
+
+// APARAM app function DP_CRYPT_APP_FUNCTION
+uint32_t data_exchange_crypt_handler(Mailbox_t* mbx)
+{
+    perf_counters.session.requests++;
+    exchange_init();
+    return dp_crypt_handler(mbx);
+}
+
+uint32_t data_exchange_chunk_execute(uint32_t* req, uint32_t max_length)
+{
+    return dp_chunk_execute(chunk_object_list, chunk_object_count, req, max_length);
+}
+
+// APARAM app function DP_CHUNK_APP_FUNCTION, the objects need no setup
+uint32_t data_exchange_chunk_handler(Mailbox_t* mbx)
+{
+    uint32_t* req = &mbx->content[DP_CHUNK_MBX_OFFSET];
+
+    perf_counters.session.requests++;
+    if (pipe_busy())
+    {
+        // the bottom half works on the same transfer state
+        req[0] = dp_chunk_err_busy;
+        return dp_chunk_err_busy;
+    }
+    return data_exchange_chunk_execute(req, DP_CHUNK_MAX_LEN);
 }
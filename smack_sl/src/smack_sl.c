@@ -28,45 +28,26 @@
 // smack_sl project files
 #include "smack_sl.h"
 #include "smack_dataexchange.h"
-
-//---------------------------------------------------------------------
-// NDEF Tag Definition
-//---------------------------------------------------------------------
-/* NDEF tag defined by user.
- * To activate this tag, set the field "tag_type_2_ptr" in APARAM.
- */
-const uint8_t smack_sl_tag[] =
-{
-    0x05, 0xc0, 0xbe, 0xef,
-    0xde, 0xad, 0x00, 0x00,
-    0xff, 0xff, 0xff, 0xff,
-    0xE1,
-    0x10,
-    0x0b,
-    0x0f,
-    0x03, 0x4f, 0xd1, 0x01,
-    0x4b, 0x54, 0x02, 'e',
-    'n', 'I', 'n', 'f',
-    'i', 'n', 'e', 'o',
-    'n', ' ', 'T', 'e',
-    'c', 'h', 'n', 'o',
-    'l', 'o', 'g', 'i',
-    'e', 's', ' ', 'A',
-    'G', ' ', ' ', 'N',
-    'G', 'C', '1', '0',
-    '8', '0', ' ', ' ',
-    'S', 'm', 'A', 'c',
-    'K', ' ', ' ', '0',
-    '5', 'C', '0', 'B',
-    'E', 'E', 'F', 'D',
-    'E', 'A', 'D', '0',
-    '0', '0', ' ', ' ',
-    'V', '4', '.', '0',
-    '.', '1', ' ', '(',
-    'N', 'V', 'M', ')',
-    0xfe, 0xff, 0xff, 0xff,
-    0xff, 0xff, 0xff
-};
+#include "nvm_persist.h"
+#include "timebase.h"
+#include "vclamp_tuner.h"
+#include "field_predictor.h"
+#include "charge_progress.h"
+#include "ndef_tag.h"
+#include "ota.h"
+#include "image_check.h"
+#include "boot.h"
+#include "power.h"
+#include "trace.h"
+#include "perf.h"
+#include "log.h"
+#include "provision.h"
+#include "spi.h"
+#include "irq_map.h"
+#include "irq_bench.h"
+#include "nfc_event.h"
+#include "aes_key.h"
+#include "dp_crypt.h"
 
 //---------------------------------------------------------------------
 // Definitions
@@ -75,14 +56,6 @@ const uint8_t smack_sl_tag[] =
 #define WAIT_ABOUT_1MS   0x8000   //!< clock tick constant ~1ms @ 28MHz
 #endif
 
-
-/*
-   Previous firmware stored version data in the last flash page (0x1EFF4–0x1EFFF).
-   To avoid conflicts, we now store the LED state in the previous page.
-   Assuming a page size of 128 bytes, the previous page spans 0x0001EF00–0x0001EF7F.
-   Here we reserve address 0x0001EF10 for the LED state.
-*/
-#define LOCK_STATE_ADDR    0x0001EF10   // New LED state address
 #define LED_GPIO          1            // LED is connected to GPIO1
 
 /* TODO:
@@ -94,8 +67,12 @@ const uint8_t smack_sl_tag[] =
 // Global Variables
 //---------------------------------------------------------------------
 uint32_t sl_counter;
-Power_State_enum_t current_state = POWER_POWER_OFF;
+volatile Power_State_enum_t current_state = POWER_POWER_OFF;
 uint32_t turn_cycles = 0;
+motor_stats_t motor_stats;
+
+// passcode or REGISTER_RQ of the last auth request, published by its event (nfc_event.h)
+static volatile uint32_t auth_request;
 
 /**
  * H-BRIDGE LAYOUT
@@ -164,7 +141,7 @@ void hardfault_handler(void)
 void sweep_voltages(void)
 {
     Mailbox_t* mbx = get_mailbox_address();
-    if (shc_compare(shc_channel_ma, get_threshold_from_voltage(3.0)) == false)
+    if (shc_compare(shc_channel_ma, get_threshold_from_voltage(MOTOR_THRESHOLD_VOLTAGE)) == false)
     {
         mbx->content[6] = voltage_sweep;
         done_sweep = true;
@@ -176,7 +153,7 @@ void sweep_voltages(void)
 }
 
 /* Toggle lock state for H-Bridge control */
-void toggle_lock(bool *hs1, bool *ls1, bool *hs2, bool *ls2, bool lock)
+RAMFUNC void toggle_lock(bool *hs1, bool *ls1, bool *hs2, bool *ls2, bool lock)
 {
     if (lock)
     {
@@ -236,18 +213,64 @@ void toggle_lock(bool *hs1, bool *ls1, bool *hs2, bool *ls2, bool lock)
     }
 }
 
-/* Function to control the motor */
-void turn_motor(Mailbox_t* mbx, bool* hs1, bool* ls1, bool* hs2, bool* ls2, bool lock)
+/* Answer an NFC frame pending during a motor pulse. Its handlers run from NVM, which is switched on meanwhile.
+   The SysTick keeps counting without its interrupt, ram_delay() still sees the end of the pulse. */
+static RAMFUNC void nfc_window(void)
 {
-    const uint32_t wait_time_discharge = WAIT_ABOUT_1MS * 32;
-    const uint32_t wait_time_charge = WAIT_ABOUT_1MS;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+#ifndef NO_RAMFUNC
+    switch_on_nvm();
+    nvm_config();
+#endif
+    __enable_irq();
+    __ISB();
+    __disable_irq();
+#ifndef NO_RAMFUNC
+    switch_off_nvm();
+#endif
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    motor_stats.nfc_frames++;
+}
 
-    while (!shc_compare(shc_channel_ma, get_threshold_from_voltage(3.0)))
+/* Wait on the SysTick with interrupts disabled, WFI still wakes up on the pending SysTick and NFC interrupts.
+   A running SysTick (profiler.h) is restarted afterwards. */
+static RAMFUNC void ram_delay(uint32_t ticks)
+{
+    uint32_t ctrl = SysTick->CTRL & (SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk);
+    uint32_t load = SysTick->LOAD;
+
+    SysTick->CTRL = 0;
+    SysTick->LOAD = ticks - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    while ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) == 0)
     {
-        mbx->content[5] = 0x22222222;
+        __WFI();
+        // the register, NVIC_GetPendingIRQ() is not guaranteed to be inlined into RAM
+        if ((NVIC->ISPR[0U] & (1UL << (uint32_t) Cl_uart_IRQn)) != 0U)
+        {
+            nfc_window();
+        }
     }
+    SysTick->CTRL = 0;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+    SysTick->LOAD = load;
+    SysTick->VAL = 0;
+    SysTick->CTRL = ctrl;
+}
+
+/* Drive one motor pulse. The NVM is switched off meanwhile, so only RAM and ROM code may run,
+   other than the NFC replies (nfc_window()). */
+static RAMFUNC void motor_pulse(bool* hs1, bool* ls1, bool* hs2, bool* ls2, bool lock, uint32_t ticks)
+{
+    __disable_irq();
+#ifndef NO_RAMFUNC
+    switch_off_nvm();
+#endif
     toggle_lock(hs1, ls1, hs2, ls2, lock);
-    sys_tim_singleshot_32(0, wait_time_discharge, 14);
+    ram_delay(ticks);
     if (!lock)
     {
         *ls2 = false;
@@ -257,7 +280,43 @@ void turn_motor(Mailbox_t* mbx, bool* hs1, bool* ls1, bool* hs2, bool* ls2, bool
         *ls1 = false;
     }
     set_hb_switch(*hs1, *ls1, *hs2, *ls2);
-    sys_tim_singleshot_32(0, wait_time_charge, 14);
+#ifndef NO_RAMFUNC
+    switch_on_nvm();
+    nvm_config();
+#endif
+    __enable_irq();
+}
+
+/* Function to control the motor */
+void turn_motor(Mailbox_t* mbx, bool* hs1, bool* ls1, bool* hs2, bool* ls2, bool lock)
+{
+    const uint32_t wait_time_discharge = WAIT_ABOUT_1MS * 32;
+    const uint32_t wait_time_charge = WAIT_ABOUT_1MS;
+    const uint16_t threshold = get_threshold_from_voltage(MOTOR_THRESHOLD_VOLTAGE);
+    uint16_t compares = 1;
+    uint32_t start = timebase_now();
+    uint32_t waited;
+
+    // the comparator code runs from RAM as well (Linker_config.ld)
+    while (!shc_compare(shc_channel_ma, threshold))
+    {
+        mbx->content[5] = 0x22222222;
+        compares++;
+    }
+    waited = timebase_ticks_since(start);
+    motor_stats.compares = compares;
+    motor_stats.compare_ticks = waited / compares;
+    perf_counters.session.threshold_checks += compares;
+    perf_counters.session.threshold_wait_ticks += waited;
+
+    start = timebase_now();
+    motor_pulse(hs1, ls1, hs2, ls2, lock, wait_time_discharge);
+    motor_stats.nvm_off_ticks = timebase_ticks_since(start);
+    motor_stats.nvm_off_total += motor_stats.nvm_off_ticks;
+    motor_stats.pulses++;
+    perf_counters.session.motor_pulses++;
+
+    sys_tim_singleshot_32(MOTOR_TIMER_CHANNEL, wait_time_charge, MOTOR_TIMER_LINE);
 }
 
 /* Helper function: convert voltage (in volts) to threshold ticks. */
@@ -276,15 +335,13 @@ uint16_t get_threshold_from_voltage(float input_voltage)
  *   - Reads the current LED state from flash memory.
  *   - Toggles it (0 becomes 1; nonzero becomes 0).
  *   - Powers up and configures the NVM.
- *   - Opens the assembly buffer for the flash page containing LOCK_STATE_ADDR.
+ *   - Opens the assembly buffer for the persistent flash page (see nvm_persist.h).
  *   - Updates the state word in the assembly buffer.
- *   - Erases the flash page.
- *   - Programs the flash page with the new value.
- *   - Verifies the programming.
+ *   - Stages pending vclamp tuning results and the lifetime counters into the same page.
+ *   - Erases and programs the flash page.
  *   - Powers down the NVM.
- *   - Updates GPIO1 (using set_singlegpio_out) to reflect the new state.
  *
- * @return The new LED state (0 or 1), or a nonzero error code if an NVM operation fails.
+ * @return The new lock state (0 or 1).
  */
 bool toggle_lock_state(void)
 {
@@ -299,24 +356,24 @@ bool toggle_lock_state(void)
     // Toggle state: if 0 then 1; otherwise, set to 0.
     uint32_t new_state = (current_state == 0) ? 1 : 0;
 
-    // Open the assembly buffer for the flash page that includes LOCK_STATE_ADDR
-    err = nvm_open_assembly_buffer(LOCK_STATE_ADDR);
+    // Open the assembly buffer for the persistent flash page
+    err = nvm_persist_open();
 
     // Write the new LED state into the assembly buffer
     *((volatile uint32_t*) LOCK_STATE_ADDR) = new_state;
 
-    // Erase the flash page (ensure LOCK_STATE_ADDR is in a dedicated page)
-    nvm_erase_page();
-    nvm_program_page();
+    // Piggyback the tuning table and the lifetime counters on this erase cycle
+    vclamp_tuner_stage();
+    perf_stage();
 
-    nvm_config();
+    err = nvm_persist_commit();
 
     return new_state;
 }
 
 void generate_passcode(Mailbox_t *mbx, uint32_t arr[]) {
     uint32_t new_pc[4];
-    generate_random_number(&new_pc);
+    aes_key_random(new_pc);
     mbx->content[6] = new_pc[0];
     nvm_config();
 
@@ -326,13 +383,23 @@ void generate_passcode(Mailbox_t *mbx, uint32_t arr[]) {
     // Write the new LED state into the assembly buffer
     uint32_t lock_state_addr = (uint32_t) arr;
     arr[1] = (uint32_t) new_pc[0];
+    perf_stage();
     // Erase the flash page (ensure LOCK_STATE_ADDR is in a dedicated page)
-    nvm_erase_page();
-    err = nvm_program_page();
+    err = nvm_write_page();
 
     nvm_config();
 }
 
+// APARAM app function AUTH_APP_FUNCTION
+void auth_handler(void)
+{
+    Mailbox_t* mbx = get_mailbox_address();
+    uint32_t request = mbx->content[2];
+
+    auth_request = request;
+    nfc_event_post((request == REGISTER_RQ) ? nfc_event_register : nfc_event_auth, 0);
+}
+
 //---------------------------------------------------------------------
 // State Machine Functions
 //---------------------------------------------------------------------
@@ -342,9 +409,38 @@ void run_power_state_machine(void)
     Mailbox_t* mbx = get_mailbox_address();
     bool hs1 = true, hs2 = false, ls1 = false, ls2 = false;
     bool locked = true;
+    uint32_t traced_state = UINT32_MAX;
+    uint32_t traced_decision = UINT32_MAX;
+    ring_event_t event;
+    uint16_t request = 0;
 
     while (true)
     {
+#ifdef UART_PROVISION
+        // frames received by the UART handler
+        provision_poll();
+#endif
+#ifdef UART_LOG
+        // switches the UART off when the log is sent
+        log_poll();
+#endif
+        // requests completed in the NFC interrupt
+        while (nfc_event_get(&event))
+        {
+            trace_event(trace_request, event.id);
+            LOG2("nfc request %u done, 0x%04x", event.id, event.arg);
+            if ((event.id == (uint16_t) nfc_event_auth) || (event.id == (uint16_t) nfc_event_register))
+            {
+                // the latest one wins, auth_request holds its passcode
+                request = event.id;
+            }
+        }
+        if ((uint32_t) current_state != traced_state)
+        {
+            traced_state = (uint32_t) current_state;
+            trace_event(trace_state, (uint16_t) traced_state);
+        }
+
         switch (current_state)
         {
             case POWER_POWER_OFF:
@@ -356,37 +452,57 @@ void run_power_state_machine(void)
             {
                 nvm_config();
                 uint32_t* arr = ((volatile uint32_t*) LOCK_STATE_ADDR);
-                if (mbx->content[2] == arr[1])
+                // the provisioned passcode is valid until the first one is generated
+                uint32_t passcode = (arr[1] != 0xFFFFFFFFUL) ? arr[1] : PROVISION_SECRET->passcode;
+                if (request == 0U)
+                {
+                    // waiting for the reader
+                    (void) image_check_step();
+                }
+                else if ((request == (uint16_t) nfc_event_auth) && (auth_request == passcode))
                 {
                     authenticated = true;
+                    trace_event(trace_auth, 1);
+                    LOG1("passcode accepted, lock state %u", arr[0]);
+                    perf_counters.session.auth_ok++;
                     current_state = POWER_HARVESTING;
                     generate_passcode(mbx, arr);
                     mbx->content[3] = PC_VAL;
                     set_hb_switch(hs1, ls1, hs2, ls2);
+                    power_acquire(power_domain_shc);
+                    vclamp_tuner_begin();
+                    charge_progress_start();
+                    ndef_tag_set_event(ndef_event_auth_ok);
+                    ndef_tag_new_nonce();
                 }
-                else if (mbx->content[2] == REGISTER_RQ){
-                    mbx->content[4] = SERIAL_NUMBER;
+                else if (request == (uint16_t) nfc_event_register)
+                {
+                    mbx->content[4] = provision_serial();
                     generate_passcode(mbx, arr);
-                    mbx->content[2] = ZERO_32;
+                    ndef_tag_set_event(ndef_event_registered);
 
                     current_state = POWER_POWER_OFF;
                 }
-                else if (mbx->content[2] == ZERO_32)
-                {
-                    current_state = POWER_READY_FOR_PASSCODE;
-                }
                 else
                 {
                     mbx->content[3] = PC_INVAL;
+                    trace_event(trace_auth, 0);
+                    LOG1("passcode rejected: 0x%08x", auth_request);
+                    perf_counters.session.auth_failures++;
+                    ndef_tag_set_event(ndef_event_auth_failed);
                     current_state = POWER_IDLE;
                 }
+                request = 0;
             }
                 break;
 
             case POWER_HARVESTING:
-                if (shc_compare(shc_channel_ma, get_threshold_from_voltage(3.0)) == true)
+                perf_counters.session.harvest_checks++;
+                if (charge_progress_reached())
                 {
+                    vclamp_tuner_end();
                     mbx->content[5] = 0x11111111;
+                    LOG1("harvesting done after %u checks", perf_counters.session.harvest_checks);
                     current_state = POWER_HARVESTING_DONE;
                 }
                 break;
@@ -394,19 +510,47 @@ void run_power_state_machine(void)
             case POWER_HARVESTING_DONE:
                 // Power up and configure the NVM using ROM routines
                 {
+                    field_decision_t decision = field_predictor_evaluate();
+                    if ((uint32_t) decision != traced_decision)
+                    {
+                        traced_decision = (uint32_t) decision;
+                        trace_event(trace_field, (uint16_t) decision);
+                        LOG1("field decision %u", decision);
+                    }
+                    if (decision != field_decision_go)
+                    {
+                        if (decision == field_decision_move_closer)
+                        {
+                            mbx->content[3] = FIELD_WEAK;
+                            ndef_tag_set_event(ndef_event_field_weak);
+                        }
+                        sys_tim_singleshot_32(MOTOR_TIMER_CHANNEL, WAIT_ABOUT_1MS * FIELD_PREDICTOR_RETRY_MS, MOTOR_TIMER_LINE);
+                        break;
+                    }
+
                     bool new_state = toggle_lock_state();
                     
                     // TODO: Not make this an infinite loop
+                    ndef_tag_set_lock(new_state ? LOCK_LOCKING : LOCK_UNLOCKING);
                     for(uint8_t i = 0; i < MAX_MOTOR_ROTATIONS; i++) {
+                        charge_progress_actuate(i + 1, new_state ? LOCK_LOCKING : LOCK_UNLOCKING);
+                        trace_event(trace_pulse_begin, i + 1);
                         turn_motor(mbx, &hs1, &ls1, &hs2, &ls2, new_state);
+                        trace_event(trace_pulse_end, i + 1);
                     }
+                    charge_progress_actuate(0, new_state ? LOCK_LOCKED : LOCK_UNLOCKED);
+                    LOG2("actuated, lock state %u, %u pulses", new_state, MAX_MOTOR_ROTATIONS);
+                    ndef_tag_set_lock(new_state ? LOCK_LOCKED : LOCK_UNLOCKED);
+                    ndef_tag_set_event(ndef_event_actuated);
                     mbx->content[3] = HARVESTING_DONE;
+                    power_release(power_domain_shc);
                     current_state = POWER_IDLE;
                 }
                 break;
 
             case POWER_IDLE:
                 // Remain idle; add periodic tasks or sleep logic as needed.
+                (void) image_check_step();
                 break;
 
             default:
@@ -420,23 +564,54 @@ void run_power_state_machine(void)
 //---------------------------------------------------------------------
 void _nvm_start(void)
 {
+    boot_profile_start();
+    perf_init();
+    irq_map_init();
+
+    // finish an update interrupted by a field loss before anything else runs
+    ota_resume();
+    boot_profile_mark(boot_step_ota);
+
+    // NFC first, everything else delays the first response
+    // data exchange is initialized on first use (data_exchange_handler()), the SHC when harvesting starts
     nfc_init();
+    boot_profile_mark(boot_step_nfc);
     init_dand();
-    vars_init();
-    shc_init();
-
-    volatile NFC_State_enum_t state = handle_DAND_protocol();
-    volatile NFC_Frame_enum_t frame_type = classify_frame();
-    nfc_state_machine();
+    boot_profile_mark(boot_step_dand);
+
+    vclamp_tuner_init();
+    boot_profile_mark(boot_step_tuner);
+    image_check_init();
+    boot_profile_mark(boot_step_image_check);
+    charge_progress_init();
+    ndef_tag_init();
+    boot_profile_mark(boot_step_status);
+#ifdef UART_LOG
+    log_init();
+#endif
+#ifdef UART_PROVISION
+    provision_init();
+#endif
+#ifdef SPI_BENCHMARK
+    spi_benchmark();
+#endif
+#ifdef IRQ_BENCHMARK
+    irq_bench_run();
+#endif
+#ifdef DP_CRYPT_BENCHMARK
+    dp_crypt_benchmark();
+#endif
 
+    // frames are received and answered in the NFC interrupt from here on (nfc_event.h)
     set_hb_eventctrl(false);
 
     single_gpio_iocfg(true, false, true, false, false, LED_GPIO);
+    boot_profile_mark(boot_step_protocol);
+    trace_event(trace_boot, 0);
+    LOG1("boot, session %u", perf_counters.lifetime.sessions);
 
     while (true)
     {
-        read_frame();
-        frame_type = classify_frame();
         run_power_state_machine();
         asm("WFI"); // Wait For Interrupt to conserve power.
     }
@@ -0,0 +1,234 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     spi.c
+ *  @brief    Interrupt driven SPI master transfers on the SSP.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// smack_sl project
+#include "timebase.h"
+#include "spi.h"
+
+#ifdef SPI_DRIVER
+
+//-------------------------------------------------------------
+// globals/statics
+
+// SSP registers (PL022), the ROM only covers the configuration
+#define SSP_BASE            0x20012000UL
+#define SSP_DR              (*((volatile uint32_t*) (SSP_BASE + 0x008)))
+#define SSP_SR              (*((volatile uint32_t*) (SSP_BASE + 0x00C)))
+#define SSP_CPSR            (*((volatile uint32_t*) (SSP_BASE + 0x010)))
+#define SSP_IMSC            (*((volatile uint32_t*) (SSP_BASE + 0x014)))
+#define SSP_ICR             (*((volatile uint32_t*) (SSP_BASE + 0x020)))
+#define SSP_SR_TNF          (1UL << 1)      //!< TX FIFO not full
+#define SSP_SR_RNE          (1UL << 2)      //!< RX FIFO not empty
+#define SSP_IMSC_RTIM       (1UL << 1)      //!< RX timeout interrupt
+#define SSP_IMSC_RXIM       (1UL << 2)      //!< RX FIFO half full interrupt
+#define SSP_ICR_RTIC        (1UL << 1)
+
+static const uint8_t* tx_data;
+static uint8_t* rx_data;
+static uint16_t length;
+static uint16_t sent;
+static volatile uint16_t received;
+static volatile bool busy;
+static spi_callback_t callback;
+
+#ifdef SPI_BENCHMARK
+spi_bench_t spi_bench;
+
+static spi_bench_entry_t* bench;
+#endif
+
+
+//-------------------------------------------------------------
+
+// move the data between buffers and FIFOs, to be called with interrupts disabled
+static void service(void)
+{
+    uint16_t count = received;
+
+    while ((SSP_SR & SSP_SR_RNE) != 0)
+    {
+        uint8_t value = (uint8_t) SSP_DR;
+
+        if ((rx_data != NULL) && (count < length))
+        {
+            rx_data[count] = value;
+        }
+        count++;
+    }
+    received = count;
+
+    // at most one FIFO of bytes in flight, so the RX FIFO never overruns
+    while ((sent < length) && ((sent - count) < SPI_FIFO_DEPTH) && ((SSP_SR & SSP_SR_TNF) != 0))
+    {
+        SSP_DR = (tx_data != NULL) ? tx_data[sent] : SPI_FILL;
+        sent++;
+    }
+
+    if (count >= length)
+    {
+        SSP_IMSC = 0;
+        busy = false;
+        if (callback != NULL)
+        {
+            callback(length);
+        }
+    }
+}
+
+void spi_init(uint8_t scr, ssp_polarity_t polarity, ssp_phase_t phase, bool loop_back)
+{
+    control_spi(false, false);
+    config_spi(scr, ssp_master, 8, polarity, phase);
+    SSP_CPSR = SPI_PRESCALE;
+    // routes the SSP to SPI_IRQ, the interrupts are enabled per transfer
+    config_ssp_irqs(false, false, false, false, SPI_IRQ);
+    control_spi(true, loop_back);
+
+    while ((SSP_SR & SSP_SR_RNE) != 0)
+    {
+        (void) SSP_DR;
+    }
+    busy = false;
+}
+
+void spi_close(void)
+{
+    SSP_IMSC = 0;
+    control_spi(false, false);
+    busy = false;
+}
+
+bool spi_start(const uint8_t* tx, uint8_t* rx, uint16_t count, spi_callback_t done)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    if (busy)
+    {
+        return false;
+    }
+
+    tx_data = tx;
+    rx_data = rx;
+    length = count;
+    sent = 0;
+    received = 0;
+    callback = done;
+    busy = true;
+
+    __disable_irq();
+    service();
+    if (busy)
+    {
+        SSP_IMSC = SSP_IMSC_RXIM | SSP_IMSC_RTIM;
+    }
+    __set_PRIMASK(primask);
+
+    return true;
+}
+
+bool spi_busy(void)
+{
+    return busy;
+}
+
+void spi_wait(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    // the interrupt wakes the core, checking busy with interrupts disabled avoids sleeping after it
+    __disable_irq();
+    while (busy)
+    {
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+    __set_PRIMASK(primask);
+}
+
+void spi_ssp_handler(void)
+{
+#ifdef SPI_BENCHMARK
+    uint32_t start = timebase_now();
+#endif
+
+    SSP_ICR = SSP_ICR_RTIC;
+    service();
+
+#ifdef SPI_BENCHMARK
+    if (bench != NULL)
+    {
+        bench->irqs++;
+        bench->busy_ticks += timebase_ticks_since(start);
+    }
+#endif
+}
+
+#ifdef SPI_BENCHMARK
+
+void spi_benchmark(void)
+{
+    static const uint8_t scr[SPI_BENCH_RATES] = { 0, 1, 3, 6, 13, 27 };
+    static uint8_t tx[SPI_BENCH_BYTES];
+    static uint8_t rx[SPI_BENCH_BYTES];
+
+    for (uint16_t i = 0; i < SPI_BENCH_BYTES; i++)
+    {
+        tx[i] = (uint8_t) (i * 7 + 1);
+    }
+
+    for (uint8_t r = 0; r < SPI_BENCH_RATES; r++)
+    {
+        spi_bench_entry_t* e = &spi_bench.rate[r];
+        uint32_t start;
+
+        spi_init(scr[r], ssp_low, ssp_first, true);
+        e->bitrate = XTAL / (SPI_PRESCALE * (1UL + scr[r]));
+        e->busy_ticks = 0;
+        e->irqs = 0;
+        e->errors = 0;
+        bench = e;
+
+        start = timebase_now();
+        (void) spi_start(tx, rx, SPI_BENCH_BYTES, NULL);
+        spi_wait();
+        e->ticks = timebase_ticks_since(start);
+
+        bench = NULL;
+        for (uint16_t i = 0; i < SPI_BENCH_BYTES; i++)
+        {
+            if (rx[i] != tx[i])
+            {
+                e->errors++;
+            }
+        }
+    }
+    spi_close();
+}
+
+#endif /* SPI_BENCHMARK */
+
+#endif /* SPI_DRIVER */
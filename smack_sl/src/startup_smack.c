@@ -31,6 +31,7 @@
  */
 
 #include "smack.h"
+#include "ram_usage.h"
 
 /*----------------------------------------------------------------------------
   Exception / Interrupt Handler Function Prototype
@@ -169,6 +170,7 @@ const pFunc __VECTOR_TABLE[48] __VECTOR_TABLE_ATTRIBUTE =
  *----------------------------------------------------------------------------*/
 void NVM_Reset_Handler(void)
 {
+    ram_usage_paint();                        /* Fill the unused RAM for the stack high-water mark */
     __NVM_PROGRAM_START();                    /* Enter NVM PreMain (C library entry point) */
 }
 
@@ -0,0 +1,51 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     timebase.c
+ *  @brief    Free running time base on a cascaded system timer pair.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack NVM lib
+#include "sys_tim_lib.h"
+
+// smack_sl project
+#include "timebase.h"
+
+
+//-------------------------------------------------------------
+
+void timebase_init(void)
+{
+    // both stages at full period: the combined counter is a plain 32 bit tick counter
+    sys_tim_cyclic_cascaded(TIMEBASE_CHANNEL, 0xffff, 0xffff);
+}
+
+uint32_t timebase_now(void)
+{
+    return sys_tim_cyclic_cascaded_get_combined(TIMEBASE_CHANNEL);
+}
+
+uint32_t timebase_ticks_since(uint32_t start)
+{
+    return timebase_now() - start;
+}
+
+uint32_t timebase_ms_since(uint32_t start)
+{
+    return timebase_ticks_since(start) / TIMEBASE_TICKS_PER_MS;
+}
@@ -0,0 +1,77 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     trace.c
+ *  @brief    Time stamped event trace of the power state machine.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// smack_sl project
+#include "timebase.h"
+#include "trace.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+static trace_record_t ring[TRACE_SIZE];
+static volatile uint32_t written;
+
+trace_chunk_t trace_chunk;
+uint32_t trace_cursor;
+
+
+//-------------------------------------------------------------
+
+void trace_event(trace_event_t event, uint16_t arg)
+{
+    uint32_t primask = __get_PRIMASK();
+    trace_record_t* r;
+
+    __disable_irq();
+    r = &ring[written & (TRACE_SIZE - 1)];
+    r->time = timebase_now();
+    r->event = (uint16_t) event;
+    r->arg = arg;
+    written++;
+    __set_PRIMASK(primask);
+}
+
+void trace_notify_tx(uint16_t data_point_id)
+{
+    uint32_t end = written;
+    uint32_t first = trace_cursor;
+    uint8_t count = 0;
+
+    (void) data_point_id;
+
+    // continue with the oldest record if the read position has been overwritten
+    if ((end - first) > TRACE_SIZE)
+    {
+        first = end - TRACE_SIZE;
+    }
+    while ((count < TRACE_CHUNK) && ((first + count) != end))
+    {
+        trace_chunk.record[count] = ring[(first + count) & (TRACE_SIZE - 1)];
+        count++;
+    }
+
+    trace_chunk.written = end;
+    trace_chunk.first = first;
+    trace_chunk.count = count;
+    trace_cursor = first + count;
+}
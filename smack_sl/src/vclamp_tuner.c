@@ -0,0 +1,192 @@
+/* ============================================================================
+** Copyright (c) 2022 Infineon Technologies AG
+**               All rights reserved.
+**               www.infineon.com
+** ============================================================================
+**
+** ============================================================================
+** Redistribution and use of this software only permitted to the extent
+** expressly agreed with Infineon Technologies AG.
+** ============================================================================
+*
+*/
+
+/** @file     vclamp_tuner.c
+ *  @brief    Adaptive vclamp selection based on measured charge times.
+ */
+
+// standard libs
+#include "core_cm0.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Smack ROM lib
+#include "rom_lib.h"
+
+// Smack NVM lib
+#include "shc_lib.h"
+#include "system_lib.h"
+
+// smack_sl project
+#include "smack_sl.h"
+#include "timebase.h"
+#include "nvm_persist.h"
+#include "vclamp_tuner.h"
+
+
+//-------------------------------------------------------------
+// globals/statics
+
+vclamp_tuner_stats_t vclamp_tuner_stats;
+
+// upper RSSI limits of the lower bands, the last band takes everything above
+static const uint16_t band_limit[VCLAMP_TUNER_BANDS - 1] = {0x100, 0x200, 0x300};
+
+static vclamp_tuner_band_t table[VCLAMP_TUNER_BANDS];
+static uint32_t start_time;
+static bool active;
+static bool dirty;
+
+
+//-------------------------------------------------------------
+
+static uint8_t get_band(uint16_t rssi)
+{
+    uint8_t band = 0;
+
+    while ((band < (VCLAMP_TUNER_BANDS - 1)) && (rssi >= band_limit[band]))
+    {
+        band++;
+    }
+    return band;
+}
+
+static uint8_t get_best_setting(const vclamp_tuner_band_t* entry)
+{
+    uint8_t best = vclamp_tuner_stats.default_setting;
+
+    for (uint8_t i = 0; i < VCLAMP_TUNER_SETTINGS; i++)
+    {
+        if (entry->charge_ms[i] < entry->charge_ms[best])
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Settings without measurement are explored first, starting with the factory setting.
+static uint8_t select_setting(const vclamp_tuner_band_t* entry, bool* explore)
+{
+    *explore = true;
+    if (entry->charge_ms[vclamp_tuner_stats.default_setting] == VCLAMP_TUNER_UNKNOWN)
+    {
+        return vclamp_tuner_stats.default_setting;
+    }
+    for (uint8_t i = 0; i < VCLAMP_TUNER_SETTINGS; i++)
+    {
+        if (entry->charge_ms[i] == VCLAMP_TUNER_UNKNOWN)
+        {
+            return i;
+        }
+    }
+    *explore = false;
+    return get_best_setting(entry);
+}
+
+void vclamp_tuner_init(void)
+{
+    const vclamp_tuner_band_t* stored = (const vclamp_tuner_band_t*) VCLAMP_TABLE_ADDR;
+
+    for (uint8_t band = 0; band < VCLAMP_TUNER_BANDS; band++)
+    {
+        table[band] = stored[band];
+    }
+    vclamp_tuner_stats.default_setting = vclamp_get();
+    if (vclamp_tuner_stats.default_setting >= VCLAMP_TUNER_SETTINGS)
+    {
+        vclamp_tuner_stats.default_setting = 0;
+    }
+    active = false;
+    dirty = false;
+}
+
+void vclamp_tuner_begin(void)
+{
+    bool explore;
+    uint16_t rssi = get_nfc_value(nfc_sel_rssi);
+    uint8_t band = get_band(rssi);
+    uint8_t setting = select_setting(&table[band], &explore);
+
+    vclamp_set(setting);
+
+    vclamp_tuner_stats.rssi = rssi;
+    vclamp_tuner_stats.band = band;
+    vclamp_tuner_stats.setting = setting;
+    vclamp_tuner_stats.explored = explore ? 1 : 0;
+    vclamp_tuner_stats.charge_ms = VCLAMP_TUNER_UNKNOWN;
+
+    // a charged capacitor gives no information about the charge rate
+    active = !shc_compare(shc_channel_ma, get_threshold_from_voltage(MOTOR_THRESHOLD_VOLTAGE));
+    start_time = timebase_now();
+}
+
+void vclamp_tuner_end(void)
+{
+    vclamp_tuner_band_t* entry;
+    uint16_t* stored;
+    uint32_t ms;
+
+    if (!active)
+    {
+        return;
+    }
+    active = false;
+
+    ms = timebase_ms_since(start_time);
+    if (ms >= VCLAMP_TUNER_UNKNOWN)
+    {
+        ms = VCLAMP_TUNER_UNKNOWN - 1;
+    }
+
+    entry = &table[vclamp_tuner_stats.band];
+    stored = &entry->charge_ms[vclamp_tuner_stats.setting];
+    if (*stored == VCLAMP_TUNER_UNKNOWN)
+    {
+        *stored = (uint16_t) ms;
+    }
+    else
+    {
+        // smoothing: new = 3/4 old + 1/4 measurement
+        *stored = (uint16_t) ((3UL * *stored + ms) / 4UL);
+    }
+    dirty = true;
+
+    vclamp_tuner_stats.charge_ms = (uint16_t) ms;
+    vclamp_tuner_stats.default_ms = entry->charge_ms[vclamp_tuner_stats.default_setting];
+    vclamp_tuner_stats.best_ms = entry->charge_ms[get_best_setting(entry)];
+}
+
+uint16_t vclamp_tuner_expected_ms(uint16_t rssi)
+{
+    const vclamp_tuner_band_t* entry = &table[get_band(rssi)];
+
+    return entry->charge_ms[get_best_setting(entry)];
+}
+
+bool vclamp_tuner_stage(void)
+{
+    volatile uint32_t* dst = (volatile uint32_t*) VCLAMP_TABLE_ADDR;
+    const uint32_t* src = (const uint32_t*) table;
+
+    if (!dirty)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < (sizeof(table) / (sizeof(uint32_t))); i++)
+    {
+        dst[i] = src[i];
+    }
+    dirty = false;
+    return true;
+}
@@ -75,6 +75,14 @@ DPARAM_XML_FILES = $(sort $(foreach file, $(notdir $(DPARAM_SOURCE_FILES)), \
 # 	'.version' section of the ELF file.
 CODE_ID_CALCULATOR := $(SCRIPT_DIR)/code_id_calculator.py
 
+# Python script calculates the CRC of the NVM image as checked by the firmware at startup and sets
+# 	it in the '.version' section of the ELF file (SDK build with IMAGE_CRC set, see image_check.h).
+IMAGE_CRC_STAMP := $(SCRIPT_DIR)/image_crc_stamp.py
+
+# Python script lists the static RAM usage per module from the map file of the NVM image
+# 	(<image>_ram.txt next to the image, see ram_usage.h). Not part of the build: "make ram_report".
+RAM_REPORT := $(SCRIPT_DIR)/ram_report.py
+
 ###################################################################################################
 # Targets
 ###################################################################################################
@@ -96,6 +104,11 @@ ifeq ($(SDK),0)
 $(TARGET_IMAGE_NVM_FILE): $(LINKED_IMAGE_NVM_FILE) $(LINKED_APARAM_IMAGE_FILES) $(LINKED_DPARAM_IMAGE_FILES) | $(CODE_ID_CALCULATOR)
 	@$(ECHO) calculating the code identification (commit_id, dirty, crc) of $<, including it into $@
 	$(V)$(PYTHON) $(CODE_ID_CALCULATOR) 'NVM' $< $@
+else ifneq ($(IMAGE_CRC),)
+# no code identification, only the image CRC: "make IMAGE_CRC=1", needs Python on the PATH
+$(TARGET_IMAGE_NVM_FILE): $(LINKED_IMAGE_NVM_FILE) $(LINKED_APARAM_IMAGE_FILES) $(LINKED_DPARAM_IMAGE_FILES) | $(IMAGE_CRC_STAMP)
+	@$(ECHO) stamping the image CRC of $< into $@
+	$(V)$(PYTHON) $(IMAGE_CRC_STAMP) $< $@
 else
 # no Python
 $(TARGET_IMAGE_NVM_FILE): $(LINKED_IMAGE_NVM_FILE) $(LINKED_APARAM_IMAGE_FILES) $(LINKED_DPARAM_IMAGE_FILES)
@@ -111,6 +124,12 @@ $(TARGET_IMAGE_RAM_FILE): $(LINKED_IMAGE_RAM_FILE) $(LINKED_APARAM_IMAGE_FILES)
 	@$(ECHO) calculating the code identification (commit_id, dirty, crc) of $<, including it into $@
 	$(V)$(PYTHON) $(CODE_ID_CALCULATOR) 'RAM' $< $@
 
+# on request only, needs Python on the PATH
+.PHONY: ram_report
+ram_report: $(TARGET_IMAGE_NVM_FILE) | $(RAM_REPORT)
+	@$(ECHO) listing the static RAM usage of $< into $(basename $<)_ram.txt
+	$(V)$(PYTHON) $(RAM_REPORT) $(basename $(LINKED_IMAGE_NVM_FILE)).map $(basename $<)_ram.txt
+
 	
 # For the aparam stuff:
 # What is left to do (but will never be done, we move to scons first ... :-):
@@ -140,6 +159,7 @@ help: rombuild_help
 .PHONY: rombuild_help
 rombuild_help:
 	@$(ECHO) 'make all              Build all targets'
+	@$(ECHO) 'make ram_report       Write the static RAM usage of the NVM image (Python)'
 
 ###################################################################################################
 # Framework Includes